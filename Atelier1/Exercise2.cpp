@@ -1,4 +1,5 @@
 #include <iostream>
+#include <array>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -7,27 +8,223 @@
 #include <ctime>
 #include <chrono>
 #include <cmath>
+#include <algorithm>
 
-// Fonction de hachage SHA-256 simplifiée
+// Fonction de hachage SHA-256 (FIPS 180-4, évaluable à la compilation)
 class SHA256 {
 public:
-    static std::string hash(const std::string& input) {
-        uint64_t h1 = 0xcbf29ce484222325ULL;
-        uint64_t h2 = 0x6a09e667bb67ae85ULL;
+    using Digest = std::array<uint8_t, 32>;
+    
+    // Contexte incrémental: permet de hacher plusieurs morceaux sans les
+    // concaténer, y compris dans une expression constexpr
+    class Context {
+    private:
+        uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                             0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        uint8_t buffer[64] = {};
+        size_t buffered = 0;
+        uint64_t totalBytes = 0;
         
-        for (char c : input) {
-            h1 = (h1 ^ static_cast<uint64_t>(c)) * 0x100000001b3ULL;
-            h2 = (h2 * 33) ^ static_cast<uint64_t>(c);
+        static constexpr uint32_t rotr(uint32_t x, uint32_t n) {
+            return (x >> n) | (x << (32 - n));
         }
         
-        std::stringstream ss;
-        ss << std::hex << std::setfill('0') 
-           << std::setw(16) << h1 
-           << std::setw(16) << h2;
-        return ss.str();
+        constexpr void compress(const uint8_t* block) {
+            constexpr uint32_t K[64] = {
+                0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+                0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+                0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+                0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+                0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+                0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+                0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+                0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+            };
+            
+            uint32_t w[64] = {};
+            for (int i = 0; i < 16; i++) {
+                w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+                       (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+            }
+            for (int i = 16; i < 64; i++) {
+                uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            
+            for (int i = 0; i < 64; i++) {
+                uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+                uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+            
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+        
+    public:
+        constexpr Context() {}
+        
+        constexpr Context& update(const char* data, size_t len) {
+            totalBytes += len;
+            for (size_t i = 0; i < len; i++) {
+                buffer[buffered++] = static_cast<uint8_t>(data[i]);
+                if (buffered == 64) {
+                    compress(buffer);
+                    buffered = 0;
+                }
+            }
+            return *this;
+        }
+        
+        // Chaîne C terminée par '\0' (longueur calculée, utilisable en constexpr)
+        constexpr Context& update(const char* str) {
+            size_t len = 0;
+            while (str[len] != '\0') len++;
+            return update(str, len);
+        }
+        
+        // Ajoute un entier non signé sous sa forme décimale (comme operator<<)
+        constexpr Context& updateDecimal(uint64_t value) {
+            char digits[20] = {};
+            size_t n = 0;
+            do {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            for (size_t i = 0; i < n / 2; i++) {
+                char tmp = digits[i];
+                digits[i] = digits[n - 1 - i];
+                digits[n - 1 - i] = tmp;
+            }
+            return update(digits, n);
+        }
+        
+        constexpr Digest finish() {
+            uint64_t bitLength = totalBytes * 8;
+            const char pad = static_cast<char>(0x80);
+            const char zero = 0;
+            update(&pad, 1);
+            while (buffered != 56) {
+                update(&zero, 1);
+            }
+            for (int i = 7; i >= 0; i--) {
+                const char byte = static_cast<char>((bitLength >> (8 * i)) & 0xff);
+                update(&byte, 1);
+            }
+            
+            Digest out = {};
+            for (int i = 0; i < 8; i++) {
+                out[4 * i]     = static_cast<uint8_t>(state[i] >> 24);
+                out[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+                out[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+                out[4 * i + 3] = static_cast<uint8_t>(state[i]);
+            }
+            return out;
+        }
+    };
+    
+    static constexpr Digest digest(const char* data, size_t len) {
+        return Context().update(data, len).finish();
+    }
+    
+    template <size_t N>
+    static constexpr Digest digest(const char (&literal)[N]) {
+        return digest(literal, N - 1);
+    }
+    
+    // Conversion hexadécimale constexpr (utilisée pour les vecteurs de test)
+    static constexpr Digest fromHex(const char* hex) {
+        Digest out = {};
+        for (size_t i = 0; i < 32; i++) {
+            out[i] = static_cast<uint8_t>((nibble(hex[2 * i]) << 4) | nibble(hex[2 * i + 1]));
+        }
+        return out;
+    }
+    
+    static constexpr bool equal(const Digest& a, const Digest& b) {
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+    
+    // Nombre de chiffres hexadécimaux '0' en tête du hash
+    static constexpr int leadingZeroNibbles(const Digest& d) {
+        int count = 0;
+        for (size_t i = 0; i < d.size(); i++) {
+            if ((d[i] >> 4) != 0) return count;
+            count++;
+            if ((d[i] & 0x0f) != 0) return count;
+            count++;
+        }
+        return count;
+    }
+    
+    static std::string toHex(const Digest& d) {
+        static const char* digits = "0123456789abcdef";
+        std::string out(64, '0');
+        for (size_t i = 0; i < d.size(); i++) {
+            out[2 * i]     = digits[d[i] >> 4];
+            out[2 * i + 1] = digits[d[i] & 0x0f];
+        }
+        return out;
+    }
+    
+    static std::string hash(const std::string& input) {
+        return toHex(digest(input.data(), input.size()));
+    }
+    
+private:
+    static constexpr uint8_t nibble(char c) {
+        return static_cast<uint8_t>((c >= 'a') ? (c - 'a' + 10) : (c >= 'A') ? (c - 'A' + 10) : (c - '0'));
     }
 };
 
+// Vecteurs de test FIPS 180-2, vérifiés à la compilation
+static_assert(SHA256::equal(SHA256::digest(""),
+              SHA256::fromHex("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855")),
+              "SHA-256(\"\") incorrect");
+static_assert(SHA256::equal(SHA256::digest("abc"),
+              SHA256::fromHex("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad")),
+              "SHA-256(\"abc\") incorrect");
+static_assert(SHA256::equal(SHA256::digest("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+              SHA256::fromHex("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1")),
+              "SHA-256(448 bits) incorrect");
+
+// En-tête fixe du bloc genesis: identique pour tous les processus, son hash
+// est calculé à la compilation et son nonce (trouvé une fois pour toutes)
+// est vérifié par static_assert, ce qui évite de miner au démarrage
+struct GenesisHeader {
+    static constexpr const char* TIMESTAMP = "Wed Jan  1 00:00:00 2025";
+    static constexpr const char* PREVIOUS_HASH = "0";
+    static constexpr const char* TRANSACTION = "Genesis Block - First Block";
+    static constexpr int DIFFICULTY = 5;
+    static constexpr int NONCE = 6464994;
+    
+    // Même sérialisation que Block::calculateHash()
+    static constexpr SHA256::Digest computeHash() {
+        return SHA256::Context()
+            .updateDecimal(0)
+            .update(TIMESTAMP)
+            .update(PREVIOUS_HASH)
+            .updateDecimal(NONCE)
+            .update(TRANSACTION)
+            .finish();
+    }
+};
+
+constexpr SHA256::Digest GENESIS_HASH = GenesisHeader::computeHash();
+static_assert(SHA256::leadingZeroNibbles(GENESIS_HASH) >= GenesisHeader::DIFFICULTY,
+              "Le nonce du bloc genesis ne satisfait pas la difficulté");
+static_assert(SHA256::equal(GENESIS_HASH,
+              SHA256::fromHex("000008649a152b05da4c63c495eb9e924e6ed9fde8b480af650edc636768406b")),
+              "Hash du bloc genesis inattendu");
+
 // Classe représentant un bloc de la blockchain
 class Block {
 private:
@@ -60,6 +257,12 @@ private:
         return SHA256::hash(ss.str());
     }
     
+    // Bloc déjà scellé (timestamp et nonce connus)
+    Block(int idx, const std::vector<std::string>& txs, const std::string& prevHash, int diff,
+          const std::string& ts, int n, const std::string& h)
+        : index(idx), timestamp(ts), transactions(txs), previousHash(prevHash),
+          hash(h), nonce(n), difficulty(diff) {}
+    
 public:
     Block(int idx, const std::vector<std::string>& txs, const std::string& prevHash, int diff = 2)
         : index(idx), transactions(txs), previousHash(prevHash), nonce(0), difficulty(diff) {
@@ -67,32 +270,44 @@ public:
         hash = calculateHash();
     }
     
-    // Proof of Work - Mine le bloc
-    void mineBlock() {
+    // Bloc genesis figé à la compilation (aucun minage)
+    static Block* createGenesis() {
+        return new Block(0, {GenesisHeader::TRANSACTION}, GenesisHeader::PREVIOUS_HASH,
+                         GenesisHeader::DIFFICULTY, GenesisHeader::TIMESTAMP,
+                         GenesisHeader::NONCE, SHA256::toHex(GENESIS_HASH));
+    }
+    
+    // Recherche du nonce, sans affichage; renvoie le nombre de hachages calculés
+    uint64_t solve() {
         std::string target(difficulty, '0');
-        auto start = std::chrono::high_resolution_clock::now();
-        
-        std::cout << "🔨 Mining block " << index << " avec difficulté " << difficulty 
-                  << " (hash doit commencer par " << target << ")..." << std::endl;
-        
         nonce = 0;
         hash = calculateHash();
+        uint64_t attempts = 1;
         
-        while (hash.substr(0, difficulty) != target) {
+        while (hash.compare(0, difficulty, target) != 0) {
             nonce++;
             hash = calculateHash();
-            
-            // Afficher la progression tous les 100000 essais
-            if (nonce % 100000 == 0) {
-                std::cout << "  Essai #" << nonce << " - Hash: " << hash.substr(0, 10) << "..." << std::endl;
-            }
+            attempts++;
         }
+        return attempts;
+    }
+    
+    // Proof of Work - Mine le bloc (affichages hors de la mesure)
+    void mineBlock() {
+        std::string target(difficulty, '0');
+        std::cout << "🔨 Mining block " << index << " avec difficulté " << difficulty 
+                  << " (hash doit commencer par " << target << ")..." << std::endl;
         
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        auto start = std::chrono::steady_clock::now();
+        uint64_t attempts = solve();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
         
-        std::cout << "✅ Bloc miné! Nonce: " << nonce << std::endl;
-        std::cout << "⏱️  Temps d'exécution: " << duration.count() << " ms" << std::endl;
+        std::cout << "✅ Bloc miné! Nonce: " << nonce << " (" << attempts << " essais)" << std::endl;
+        std::ostringstream rate;
+        rate << std::fixed << std::setprecision(2) << ms << " ms, soit "
+             << std::setprecision(0) << attempts / std::max(ms / 1000, 1e-9) << " H/s";
+        std::cout << "⏱️  Temps d'exécution: " << rate.str() << std::endl;
         std::cout << "🔐 Hash: " << hash << std::endl;
         std::cout << std::endl;
     }
@@ -139,11 +354,8 @@ private:
     
 public:
     Blockchain(int diff = 2) : difficulty(diff) {
-        // Créer le bloc genesis
-        std::vector<std::string> genesisTxs = {"Genesis Block - First Block"};
-        Block* genesis = new Block(0, genesisTxs, "0", difficulty);
-        genesis->mineBlock();
-        chain.push_back(genesis);
+        // Le bloc genesis est fixe: pas de minage au démarrage
+        chain.push_back(Block::createGenesis());
     }
     
     ~Blockchain() {
@@ -205,46 +417,124 @@ public:
     int getSize() const { return chain.size(); }
 };
 
-// Fonction pour tester différents niveaux de difficulté
-void testDifficultyLevels() {
+// Résumé d'un échantillon de mesures: moyenne et demi-largeur de son
+// intervalle de confiance à 95 % (loi de Student), médiane et 99e centile
+struct SampleStats {
+    size_t count = 0;
+    double mean = 0;
+    double stddev = 0;
+    double ci95 = 0;
+    double median = 0;
+    double p99 = 0;
+    
+    // Quantile à 97,5 % de la loi de Student à df degrés de liberté
+    static double studentT975(size_t df) {
+        static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                       2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        if (df == 0) return 0;
+        if (df <= 30) return table[df - 1];
+        if (df <= 60) return 2.000;
+        if (df <= 120) return 1.980;
+        return 1.960;
+    }
+    
+    static SampleStats of(std::vector<double> samples) {
+        SampleStats st;
+        st.count = samples.size();
+        if (samples.empty()) return st;
+        
+        double sum = 0;
+        for (double x : samples) sum += x;
+        st.mean = sum / samples.size();
+        double squares = 0;
+        for (double x : samples) squares += (x - st.mean) * (x - st.mean);
+        if (samples.size() > 1) {
+            st.stddev = std::sqrt(squares / (samples.size() - 1));
+            st.ci95 = studentT975(samples.size() - 1) * st.stddev / std::sqrt(static_cast<double>(samples.size()));
+        }
+        
+        std::sort(samples.begin(), samples.end());
+        size_t mid = samples.size() / 2;
+        st.median = (samples.size() % 2 == 1) ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2;
+        // 99e centile au rang le plus proche
+        size_t rank = static_cast<size_t>(std::ceil(0.99 * samples.size()));
+        st.p99 = samples[std::max<size_t>(rank, 1) - 1];
+        return st;
+    }
+};
+
+// Durée en millisecondes, deux décimales
+std::string formatMillis(double ms) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << ms;
+    return out.str();
+}
+
+// Coût du minage selon la difficulté. La recherche du nonce suit une loi
+// géométrique (écart-type ≈ moyenne): un seul bloc par difficulté ne dit
+// presque rien. On mine donc de nombreux blocs indépendants, hors chaîne
+// (pas de genesis ni d'affichage dans la mesure), et le nombre de blocs est
+// borné par hashBudget hachages attendus par difficulté (au moins minTrials).
+void benchmarkMining(const std::vector<int>& difficulties = {1, 2, 3, 4, 5}, double hashBudget = 2e6,
+                     size_t minTrials = 10, size_t maxTrials = 300) {
     std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
     std::cout << "║        TEST DES NIVEAUX DE DIFFICULTÉ                        ║" << std::endl;
     std::cout << "╚══════════════════════════════════════════════════════════════╝\n" << std::endl;
     
-    std::vector<int> difficulties = {1, 2, 3, 4, 5};
-    std::vector<long long> times;
+    struct Row {
+        int difficulty;
+        double expectedAttempts;
+        SampleStats millis;
+        SampleStats attempts;
+        double hashrate;
+    };
+    std::vector<Row> rows;
     
     for (int diff : difficulties) {
-        std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
-        std::cout << "   DIFFICULTÉ: " << diff << std::endl;
-        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n" << std::endl;
-        
-        auto start = std::chrono::high_resolution_clock::now();
-        
-        Blockchain testChain(diff);
-        std::vector<std::string> txs = {"Test transaction pour difficulté " + std::to_string(diff)};
-        testChain.addBlock(txs);
+        double expected = std::pow(16.0, diff);
+        size_t trials = static_cast<size_t>(std::clamp(hashBudget / expected, double(minTrials), double(maxTrials)));
+        std::cout << "⛏️  Difficulté " << diff << ": " << trials << " blocs..." << std::endl;
         
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-        times.push_back(duration.count());
+        std::vector<double> millis, attempts;
+        double totalMillis = 0, totalAttempts = 0;
+        for (size_t t = 0; t < trials; t++) {
+            // Transactions différentes à chaque bloc: recherches indépendantes
+            Block block(1, {"Bloc de mesure #" + std::to_string(t)}, "0", diff);
+            
+            auto start = std::chrono::steady_clock::now();
+            uint64_t tries = block.solve();
+            auto end = std::chrono::steady_clock::now();
+            
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            millis.push_back(ms);
+            attempts.push_back(static_cast<double>(tries));
+            totalMillis += ms;
+            totalAttempts += tries;
+        }
+        rows.push_back({diff, expected, SampleStats::of(millis), SampleStats::of(attempts),
+                        totalAttempts * 1000 / std::max(totalMillis, 1e-9)});
     }
     
-    // Afficher le tableau récapitulatif
-    std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
-    std::cout << "║           RÉSUMÉ DES TEMPS D'EXÉCUTION                       ║" << std::endl;
-    std::cout << "╠══════════════════════════════════════════════════════════════╣" << std::endl;
-    std::cout << "║ Difficulté │ Temps (ms) │ Complexité approximative          ║" << std::endl;
-    std::cout << "╠════════════╪════════════╪═══════════════════════════════════╣" << std::endl;
-    
-    for (size_t i = 0; i < difficulties.size(); i++) {
-        std::cout << "║     " << std::setw(2) << difficulties[i] 
-                  << "     │ " << std::setw(10) << std::right << times[i]
-                  << " │ ~16^" << difficulties[i] << " = " << std::setw(11) << std::left
-                  << static_cast<long long>(pow(16, difficulties[i])) << " possibilités ║" << std::endl;
+    // Afficher le tableau récapitulatif (temps en ms, moyenne ± IC 95 %)
+    std::cout << "\n╔════════════╤══════╤════════════════╤═════════════╤═════════════════════╤═══════════╤═══════════╤═════════════╗" << std::endl;
+    std::cout << "║ Difficulté │ Blocs│ Essais / 16^d  │ Hashrate H/s│ Temps moyen (ms)    │ Médiane   │ p99       │ 16^d / H/s  ║" << std::endl;
+    std::cout << "╠════════════╪══════╪════════════════╪═════════════╪═════════════════════╪═══════════╪═══════════╪═════════════╣" << std::endl;
+    for (const Row& r : rows) {
+        std::ostringstream ratio, rate;
+        ratio << std::fixed << std::setprecision(2) << r.attempts.mean / r.expectedAttempts << " ± "
+              << r.attempts.ci95 / r.expectedAttempts;
+        rate << std::fixed << std::setprecision(0) << r.hashrate;
+        // "±" occupe deux octets pour setw: largeur augmentée d'un octet
+        std::cout << "║     " << std::setw(2) << std::right << r.difficulty << "     │ " << std::setw(4) << r.millis.count
+                  << " │ " << std::setw(16) << std::left << ratio.str() << "│ " << std::setw(11) << std::right << rate.str()
+                  << " │ " << std::setw(21) << std::left << (formatMillis(r.millis.mean) + " ± " + formatMillis(r.millis.ci95))
+                  << "│ " << std::setw(9) << std::right << formatMillis(r.millis.median)
+                  << " │ " << std::setw(9) << formatMillis(r.millis.p99)
+                  << " │ " << std::setw(11) << formatMillis(r.expectedAttempts / r.hashrate * 1000) << " ║" << std::endl;
     }
-    
-    std::cout << "╚════════════╧════════════╧═══════════════════════════════════╝" << std::endl;
+    std::cout << "╚════════════╧══════╧════════════════╧═════════════╧═════════════════════╧═══════════╧═══════════╧═════════════╝" << std::endl;
+    std::cout << "💡 Essais / 16^d ≈ 1: chaque zéro exigé multiplie par 16 le travail attendu (16^d / hashrate)" << std::endl;
 }
 
 // Programme principal
@@ -292,7 +582,7 @@ int main() {
     
     // EXEMPLE 2: Test des différents niveaux de difficulté
     std::cout << "\n\n>>> EXEMPLE 2: Comparaison des niveaux de difficulté <<<" << std::endl;
-    testDifficultyLevels();
+    benchmarkMining();
     
     // EXEMPLE 3: Démonstration de sécurité
     std::cout << "\n\n>>> EXEMPLE 3: Démonstration de la sécurité (Proof of Work) <<<\n" << std::endl;
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <array>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -9,28 +10,236 @@
 #include <cmath>
 #include <cstdlib>
 #include <algorithm>
-#include <thread>
 
-// Fonction de hachage SHA-256 simplifiée
+// Fonction de hachage SHA-256 (FIPS 180-4, évaluable à la compilation)
 class SHA256 {
 public:
-    static std::string hash(const std::string& input) {
-        uint64_t h1 = 0xcbf29ce484222325ULL;
-        uint64_t h2 = 0x6a09e667bb67ae85ULL;
+    using Digest = std::array<uint8_t, 32>;
+    
+    // Contexte incrémental: permet de hacher plusieurs morceaux sans les
+    // concaténer, y compris dans une expression constexpr
+    class Context {
+    private:
+        uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                             0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        uint8_t buffer[64] = {};
+        size_t buffered = 0;
+        uint64_t totalBytes = 0;
         
-        for (char c : input) {
-            h1 = (h1 ^ static_cast<uint64_t>(c)) * 0x100000001b3ULL;
-            h2 = (h2 * 33) ^ static_cast<uint64_t>(c);
+        static constexpr uint32_t rotr(uint32_t x, uint32_t n) {
+            return (x >> n) | (x << (32 - n));
         }
         
-        std::stringstream ss;
-        ss << std::hex << std::setfill('0') 
-           << std::setw(16) << h1 
-           << std::setw(16) << h2;
-        return ss.str();
+        constexpr void compress(const uint8_t* block) {
+            constexpr uint32_t K[64] = {
+                0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+                0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+                0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+                0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+                0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+                0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+                0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+                0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+            };
+            
+            uint32_t w[64] = {};
+            for (int i = 0; i < 16; i++) {
+                w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+                       (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+            }
+            for (int i = 16; i < 64; i++) {
+                uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            
+            for (int i = 0; i < 64; i++) {
+                uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+                uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+            
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+        
+    public:
+        constexpr Context() {}
+        
+        constexpr Context& update(const char* data, size_t len) {
+            totalBytes += len;
+            for (size_t i = 0; i < len; i++) {
+                buffer[buffered++] = static_cast<uint8_t>(data[i]);
+                if (buffered == 64) {
+                    compress(buffer);
+                    buffered = 0;
+                }
+            }
+            return *this;
+        }
+        
+        // Chaîne C terminée par '\0' (longueur calculée, utilisable en constexpr)
+        constexpr Context& update(const char* str) {
+            size_t len = 0;
+            while (str[len] != '\0') len++;
+            return update(str, len);
+        }
+        
+        // Ajoute un entier non signé sous sa forme décimale (comme operator<<)
+        constexpr Context& updateDecimal(uint64_t value) {
+            char digits[20] = {};
+            size_t n = 0;
+            do {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            for (size_t i = 0; i < n / 2; i++) {
+                char tmp = digits[i];
+                digits[i] = digits[n - 1 - i];
+                digits[n - 1 - i] = tmp;
+            }
+            return update(digits, n);
+        }
+        
+        constexpr Digest finish() {
+            uint64_t bitLength = totalBytes * 8;
+            const char pad = static_cast<char>(0x80);
+            const char zero = 0;
+            update(&pad, 1);
+            while (buffered != 56) {
+                update(&zero, 1);
+            }
+            for (int i = 7; i >= 0; i--) {
+                const char byte = static_cast<char>((bitLength >> (8 * i)) & 0xff);
+                update(&byte, 1);
+            }
+            
+            Digest out = {};
+            for (int i = 0; i < 8; i++) {
+                out[4 * i]     = static_cast<uint8_t>(state[i] >> 24);
+                out[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+                out[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+                out[4 * i + 3] = static_cast<uint8_t>(state[i]);
+            }
+            return out;
+        }
+    };
+    
+    static constexpr Digest digest(const char* data, size_t len) {
+        return Context().update(data, len).finish();
+    }
+    
+    template <size_t N>
+    static constexpr Digest digest(const char (&literal)[N]) {
+        return digest(literal, N - 1);
+    }
+    
+    // Conversion hexadécimale constexpr (utilisée pour les vecteurs de test)
+    static constexpr Digest fromHex(const char* hex) {
+        Digest out = {};
+        for (size_t i = 0; i < 32; i++) {
+            out[i] = static_cast<uint8_t>((nibble(hex[2 * i]) << 4) | nibble(hex[2 * i + 1]));
+        }
+        return out;
+    }
+    
+    static constexpr bool equal(const Digest& a, const Digest& b) {
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+    
+    // Nombre de chiffres hexadécimaux '0' en tête du hash
+    static constexpr int leadingZeroNibbles(const Digest& d) {
+        int count = 0;
+        for (size_t i = 0; i < d.size(); i++) {
+            if ((d[i] >> 4) != 0) return count;
+            count++;
+            if ((d[i] & 0x0f) != 0) return count;
+            count++;
+        }
+        return count;
+    }
+    
+    static std::string toHex(const Digest& d) {
+        static const char* digits = "0123456789abcdef";
+        std::string out(64, '0');
+        for (size_t i = 0; i < d.size(); i++) {
+            out[2 * i]     = digits[d[i] >> 4];
+            out[2 * i + 1] = digits[d[i] & 0x0f];
+        }
+        return out;
+    }
+    
+    static std::string hash(const std::string& input) {
+        return toHex(digest(input.data(), input.size()));
+    }
+    
+private:
+    static constexpr uint8_t nibble(char c) {
+        return static_cast<uint8_t>((c >= 'a') ? (c - 'a' + 10) : (c >= 'A') ? (c - 'A' + 10) : (c - '0'));
     }
 };
 
+// Vecteurs de test FIPS 180-2, vérifiés à la compilation
+static_assert(SHA256::equal(SHA256::digest(""),
+              SHA256::fromHex("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855")),
+              "SHA-256(\"\") incorrect");
+static_assert(SHA256::equal(SHA256::digest("abc"),
+              SHA256::fromHex("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad")),
+              "SHA-256(\"abc\") incorrect");
+static_assert(SHA256::equal(SHA256::digest("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+              SHA256::fromHex("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1")),
+              "SHA-256(448 bits) incorrect");
+
+// En-têtes fixes des blocs genesis: leurs hash sont calculés à la compilation
+// et le nonce PoW (trouvé une fois pour toutes) est vérifié par static_assert,
+// ce qui évite de miner au démarrage et donne le même genesis partout
+struct GenesisHeader {
+    static constexpr const char* TIMESTAMP = "Wed Jan  1 00:00:00 2025";
+    static constexpr const char* PREVIOUS_HASH = "0";
+    static constexpr const char* POW_TRANSACTION = "Genesis Block PoW";
+    static constexpr int POW_DIFFICULTY = 5;
+    static constexpr int POW_NONCE = 1097433;
+    static constexpr const char* POS_TRANSACTION = "Genesis Block PoS";
+    static constexpr const char* POS_VALIDATOR = "Genesis";
+    
+    // Même sérialisation que PoWBlock::calculateHash()
+    static constexpr SHA256::Digest computePoWHash() {
+        return SHA256::Context()
+            .updateDecimal(0)
+            .update(TIMESTAMP)
+            .update(PREVIOUS_HASH)
+            .updateDecimal(POW_NONCE)
+            .update(POW_TRANSACTION)
+            .finish();
+    }
+    
+    // Même sérialisation que PoSBlock::calculateHash()
+    static constexpr SHA256::Digest computePoSHash() {
+        return SHA256::Context()
+            .updateDecimal(0)
+            .update(TIMESTAMP)
+            .update(PREVIOUS_HASH)
+            .update(POS_VALIDATOR)
+            .update(POS_TRANSACTION)
+            .finish();
+    }
+};
+
+constexpr SHA256::Digest GENESIS_POW_HASH = GenesisHeader::computePoWHash();
+constexpr SHA256::Digest GENESIS_POS_HASH = GenesisHeader::computePoSHash();
+static_assert(SHA256::leadingZeroNibbles(GENESIS_POW_HASH) >= GenesisHeader::POW_DIFFICULTY,
+              "Le nonce du bloc genesis PoW ne satisfait pas la difficulté");
+static_assert(SHA256::equal(GENESIS_POW_HASH,
+              SHA256::fromHex("00000121792a7f0786f50d5cfa5162283f9d7c353721261749ecbd340e67d4bb")),
+              "Hash du bloc genesis PoW inattendu");
+
 // Classe représentant un validateur (pour PoS)
 class Validator {
 private:
@@ -56,6 +265,55 @@ public:
     }
 };
 
+// Tirage pondéré par le stake en O(log n) (arbre de Fenwick sur des poids
+// entiers en centimes), au lieu d'un parcours cumulatif de tous les stakes
+class StakeSampler {
+private:
+    std::vector<uint64_t> tree;   // base 1: tree[i] couvre ]i - lowbit(i), i]
+    uint64_t total;
+    
+    static size_t lowbit(size_t i) { return i & (~i + 1); }
+    
+public:
+    StakeSampler() : tree(1, 0), total(0) {}
+    
+    static uint64_t weightOf(double stake) {
+        return stake > 0 ? static_cast<uint64_t>(std::llround(stake * 100)) : 0;
+    }
+    
+    void add(uint64_t weight) {
+        size_t i = tree.size();
+        uint64_t node = weight;
+        for (size_t step = 1; step < lowbit(i); step <<= 1) node += tree[i - step];
+        tree.push_back(node);
+        total += weight;
+    }
+    
+    // Élu du créneau slot, tiré de SHA256(hash précédent, slot): tout nœud
+    // retrouve le même. Renvoie le nombre de poids si leur somme est nulle.
+    size_t elect(const std::string& previousHash, int slot) const {
+        size_t n = tree.size() - 1;
+        if (total == 0) return n;
+        
+        std::string seedInput = previousHash + ":" + std::to_string(slot);
+        SHA256::Digest seed = SHA256::digest(seedInput.data(), seedInput.size());
+        uint64_t draw = 0;
+        for (int i = 0; i < 8; i++) draw |= static_cast<uint64_t>(seed[i]) << (8 * i);
+        
+        uint64_t target = draw % total;
+        size_t pos = 0;
+        size_t step = 1;
+        while (step * 2 <= n) step *= 2;
+        for (; step > 0; step >>= 1) {
+            if (pos + step <= n && tree[pos + step] <= target) {
+                pos += step;
+                target -= tree[pos];
+            }
+        }
+        return pos;
+    }
+};
+
 // Classe de base pour les blocs
 class BaseBlock {
 protected:
@@ -75,6 +333,11 @@ protected:
         return ts;
     }
     
+    // Bloc dont le timestamp est déjà fixé (genesis)
+    BaseBlock(int idx, const std::vector<std::string>& txs, const std::string& prevHash,
+              const std::string& ts)
+        : index(idx), timestamp(ts), transactions(txs), previousHash(prevHash) {}
+    
 public:
     BaseBlock(int idx, const std::vector<std::string>& txs, const std::string& prevHash)
         : index(idx), transactions(txs), previousHash(prevHash) {
@@ -107,12 +370,25 @@ private:
         return SHA256::hash(ss.str());
     }
     
+    PoWBlock(int idx, const std::vector<std::string>& txs, const std::string& prevHash, int diff,
+             const std::string& ts, int n, const std::string& h)
+        : BaseBlock(idx, txs, prevHash, ts), nonce(n), difficulty(diff) {
+        hash = h;
+    }
+    
 public:
     PoWBlock(int idx, const std::vector<std::string>& txs, const std::string& prevHash, int diff)
         : BaseBlock(idx, txs, prevHash), nonce(0), difficulty(diff) {
         hash = calculateHash();
     }
     
+    // Bloc genesis figé à la compilation (aucun minage)
+    static PoWBlock* createGenesis() {
+        return new PoWBlock(0, {GenesisHeader::POW_TRANSACTION}, GenesisHeader::PREVIOUS_HASH,
+                            GenesisHeader::POW_DIFFICULTY, GenesisHeader::TIMESTAMP,
+                            GenesisHeader::POW_NONCE, SHA256::toHex(GENESIS_POW_HASH));
+    }
+    
     long long mineBlock() {
         auto start = std::chrono::high_resolution_clock::now();
         
@@ -159,6 +435,12 @@ private:
         return SHA256::hash(ss.str());
     }
     
+    PoSBlock(int idx, const std::vector<std::string>& txs, const std::string& prevHash,
+             const std::string& val, double stake, const std::string& ts, const std::string& h)
+        : BaseBlock(idx, txs, prevHash, ts), validator(val), validatorStake(stake) {
+        hash = h;
+    }
+    
 public:
     PoSBlock(int idx, const std::vector<std::string>& txs, const std::string& prevHash, 
              const std::string& val, double stake)
@@ -166,6 +448,13 @@ public:
         hash = calculateHash();
     }
     
+    // Bloc genesis figé à la compilation
+    static PoSBlock* createGenesis() {
+        return new PoSBlock(0, {GenesisHeader::POS_TRANSACTION}, GenesisHeader::PREVIOUS_HASH,
+                            GenesisHeader::POS_VALIDATOR, 0, GenesisHeader::TIMESTAMP,
+                            SHA256::toHex(GENESIS_POS_HASH));
+    }
+    
     void display() const override {
         std::cout << "╔════════════════════════════════════════════════════════════╗" << std::endl;
         std::cout << "║ BLOC PoS #" << std::setw(47) << std::left << index << "║" << std::endl;
@@ -179,6 +468,16 @@ public:
     
     std::string getConsensusType() const override { return "Proof of Stake"; }
     std::string getValidator() const { return validator; }
+    
+    // Le hash stocké correspond-il au contenu du bloc?
+    bool hasValidHash() const { return hash == calculateHash(); }
+    
+    // Une même transaction ne peut figurer deux fois dans le bloc
+    bool hasDistinctTransactions() const {
+        std::vector<std::string> sorted(transactions);
+        std::sort(sorted.begin(), sorted.end());
+        return std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end();
+    }
 };
 
 // Blockchain Proof of Work
@@ -189,10 +488,8 @@ private:
     
 public:
     PoWBlockchain(int diff) : difficulty(diff) {
-        std::vector<std::string> genesisTxs = {"Genesis Block PoW"};
-        PoWBlock* genesis = new PoWBlock(0, genesisTxs, "0", difficulty);
-        genesis->mineBlock();
-        chain.push_back(genesis);
+        // Le bloc genesis est fixe: pas de minage au démarrage
+        chain.push_back(PoWBlock::createGenesis());
     }
     
     ~PoWBlockchain() {
@@ -212,6 +509,9 @@ public:
         return miningTime;
     }
     
+    // Hachages calculés pour miner le dernier bloc (nonces 0..n)
+    uint64_t getLastAttempts() const { return static_cast<uint64_t>(chain.back()->getNonce()) + 1; }
+    
     void display() const {
         std::cout << "\n🔨 BLOCKCHAIN PROOF OF WORK - " << chain.size() << " blocs\n" << std::endl;
         for (const auto& block : chain) {
@@ -228,34 +528,23 @@ class PoSBlockchain {
 private:
     std::vector<PoSBlock*> chain;
     std::vector<Validator> validators;
+    StakeSampler stakeSampler;
+    long long electionMicros = 0;
+    long long sealingMicros = 0;
+    long long checkMicros = 0;
     
-    // Sélectionne un validateur basé sur le stake (weighted random)
+    // Sélectionne le validateur élu pour le prochain bloc (pondéré par le stake,
+    // déterministe: dépend seulement du dernier bloc et des stakes)
     Validator* selectValidator() {
         if (validators.empty()) return nullptr;
         
-        double totalStake = 0;
-        for (const auto& v : validators) {
-            totalStake += v.getStake();
-        }
-        
-        double random = (static_cast<double>(rand()) / RAND_MAX) * totalStake;
-        double cumulative = 0;
-        
-        for (auto& v : validators) {
-            cumulative += v.getStake();
-            if (random <= cumulative) {
-                return &v;
-            }
-        }
-        
-        return &validators[0];
+        size_t index = stakeSampler.elect(chain.back()->getHash(), static_cast<int>(chain.size()));
+        return index < validators.size() ? &validators[index] : &validators[0];
     }
     
 public:
     PoSBlockchain() {
-        std::vector<std::string> genesisTxs = {"Genesis Block PoS"};
-        PoSBlock* genesis = new PoSBlock(0, genesisTxs, "0", "Genesis", 0);
-        chain.push_back(genesis);
+        chain.push_back(PoSBlock::createGenesis());
     }
     
     ~PoSBlockchain() {
@@ -266,32 +555,60 @@ public:
     
     void addValidator(const std::string& address, double stake) {
         validators.push_back(Validator(address, stake));
+        stakeSampler.add(StakeSampler::weightOf(stake));
     }
     
+    // Ajoute un bloc et renvoie le temps de travail réel (µs): élection,
+    // construction du bloc, puis les contrôles que ferait un autre validateur
     long long addBlock(const std::vector<std::string>& transactions) {
-        auto start = std::chrono::high_resolution_clock::now();
+        using Clock = std::chrono::high_resolution_clock;
+        auto micros = [](Clock::time_point from) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - from).count();
+        };
         
+        auto stage = Clock::now();
         Validator* selected = selectValidator();
         if (selected == nullptr) {
             std::cout << "❌ Aucun validateur disponible!" << std::endl;
             return 0;
         }
+        long long election = micros(stage);
         
+        stage = Clock::now();
         std::string previousHash = chain.back()->getHash();
         int index = chain.size();
-        
         PoSBlock* newBlock = new PoSBlock(index, transactions, previousHash, 
                                           selected->getAddress(), selected->getStake());
+        long long sealing = micros(stage);
         
-        // Simuler une courte validation (vérification des transactions)
-        // En PoS, pas de mining intensif, juste validation
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        // Contrôles: transactions distinctes, hash, lien et validateur élu
+        stage = Clock::now();
+        bool valid = newBlock->hasDistinctTransactions() && newBlock->hasValidHash() &&
+                     newBlock->getPreviousHash() == chain.back()->getHash();
+        size_t elected = stakeSampler.elect(previousHash, index);
+        valid = valid && elected < validators.size() &&
+                validators[elected].getAddress() == newBlock->getValidator();
+        long long checks = micros(stage);
+        
+        if (!valid) {
+            std::cout << "❌ Bloc #" << index << " rejeté" << std::endl;
+            delete newBlock;
+            return 0;
+        }
         
         chain.push_back(newBlock);
         selected->incrementBlocksValidated();
         
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        electionMicros += election;
+        sealingMicros += sealing;
+        checkMicros += checks;
+        return election + sealing + checks;
+    }
+    
+    // Temps cumulés par étape depuis la création de la chaîne (µs)
+    void displayStageTimes() const {
+        std::cout << "   ⏱️  élection " << electionMicros << " µs | construction et hash "
+                  << sealingMicros << " µs | contrôles " << checkMicros << " µs" << std::endl;
     }
     
     void display() const {
@@ -309,37 +626,104 @@ public:
         }
     }
     
+    // Chaque bloc a-t-il été produit par le validateur élu pour son créneau?
+    // Les stakes ne changent pas ici, l'élection se recalcule donc directement.
+    bool hasElectedValidators() const {
+        for (size_t i = 1; i < chain.size(); i++) {
+            size_t index = stakeSampler.elect(chain[i - 1]->getHash(), static_cast<int>(i));
+            if (index >= validators.size()) index = 0;
+            if (chain[i]->getValidator() != validators[index].getAddress()) return false;
+        }
+        return true;
+    }
+    
     int getSize() const { return chain.size(); }
 };
 
-// Fonction de comparaison
+// Complète text par des espaces jusqu'à width caractères affichés (et non
+// octets: é, µ, ± et × en occupent deux en UTF-8), aligné à gauche ou à droite
+std::string padDisplay(const std::string& text, size_t width, bool alignRight = false) {
+    size_t shown = 0;
+    for (unsigned char c : text) shown += ((c & 0xc0) != 0x80) ? 1 : 0;
+    std::string fill(width > shown ? width - shown : 0, ' ');
+    return alignRight ? fill + text : text + fill;
+}
+
+// Résumé d'un échantillon de mesures: moyenne et demi-largeur de son
+// intervalle de confiance à 95 % (loi de Student), médiane et 99e centile
+struct SampleStats {
+    size_t count = 0;
+    double mean = 0;
+    double stddev = 0;
+    double ci95 = 0;
+    double median = 0;
+    double p99 = 0;
+    
+    // Quantile à 97,5 % de la loi de Student à df degrés de liberté
+    static double studentT975(size_t df) {
+        static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                       2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        if (df == 0) return 0;
+        if (df <= 30) return table[df - 1];
+        if (df <= 60) return 2.000;
+        if (df <= 120) return 1.980;
+        return 1.960;
+    }
+    
+    static SampleStats of(std::vector<double> samples) {
+        SampleStats st;
+        st.count = samples.size();
+        if (samples.empty()) return st;
+        
+        double sum = 0;
+        for (double x : samples) sum += x;
+        st.mean = sum / samples.size();
+        double squares = 0;
+        for (double x : samples) squares += (x - st.mean) * (x - st.mean);
+        if (samples.size() > 1) {
+            st.stddev = std::sqrt(squares / (samples.size() - 1));
+            st.ci95 = studentT975(samples.size() - 1) * st.stddev / std::sqrt(static_cast<double>(samples.size()));
+        }
+        
+        std::sort(samples.begin(), samples.end());
+        size_t mid = samples.size() / 2;
+        st.median = (samples.size() % 2 == 1) ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2;
+        // 99e centile au rang le plus proche
+        size_t rank = static_cast<size_t>(std::ceil(0.99 * samples.size()));
+        st.p99 = samples[std::max<size_t>(rank, 1) - 1];
+        return st;
+    }
+};
+
+// Fonction de comparaison: NUM_BLOCKS blocs par consensus, car le minage
+// suit une loi géométrique et quelques blocs ne disent presque rien. Les
+// temps (µs) ne couvrent que le travail de chaque bloc, jamais l'affichage.
 void compareConsensus() {
     std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
     std::cout << "║            COMPARAISON: PoW vs PoS                           ║" << std::endl;
     std::cout << "╚══════════════════════════════════════════════════════════════╝\n" << std::endl;
     
-    srand(time(nullptr));
-    
-    const int NUM_BLOCKS = 5;
+    const int NUM_BLOCKS = 40;
     const int POW_DIFFICULTY = 4;
     
     // Test Proof of Work
     std::cout << "🔨 === TEST PROOF OF WORK (Difficulté " << POW_DIFFICULTY << ") ===" << std::endl;
+    std::cout << "\n🔨 Mining de " << NUM_BLOCKS << " blocs..." << std::endl;
     PoWBlockchain powChain(POW_DIFFICULTY);
     
-    std::vector<long long> powTimes;
-    auto powStart = std::chrono::high_resolution_clock::now();
+    std::vector<double> powTimes;
+    double powAttempts = 0;
     
     for (int i = 1; i <= NUM_BLOCKS; i++) {
         std::vector<std::string> txs = {"Transaction PoW #" + std::to_string(i)};
-        std::cout << "\n🔨 Mining bloc #" << i << "..." << std::endl;
-        long long time = powChain.addBlock(txs);
-        powTimes.push_back(time);
-        std::cout << "✅ Bloc miné en " << time / 1000.0 << " ms" << std::endl;
+        powTimes.push_back(static_cast<double>(powChain.addBlock(txs)));
+        powAttempts += powChain.getLastAttempts();
     }
     
-    auto powEnd = std::chrono::high_resolution_clock::now();
-    long long powTotal = std::chrono::duration_cast<std::chrono::milliseconds>(powEnd - powStart).count();
+    // Totaux en µs: somme du travail de chaque bloc, hors affichage
+    double powTotal = 0;
+    for (double t : powTimes) powTotal += t;
     
     // Test Proof of Stake
     std::cout << "\n\n💎 === TEST PROOF OF STAKE ===" << std::endl;
@@ -353,58 +737,64 @@ void compareConsensus() {
     
     posChain.displayValidators();
     
-    std::vector<long long> posTimes;
-    auto posStart = std::chrono::high_resolution_clock::now();
+    std::cout << "\n💎 Validation de " << NUM_BLOCKS << " blocs..." << std::endl;
+    std::vector<double> posTimes;
     
     for (int i = 1; i <= NUM_BLOCKS; i++) {
         std::vector<std::string> txs = {"Transaction PoS #" + std::to_string(i)};
-        std::cout << "\n💎 Validation bloc #" << i << "..." << std::endl;
-        long long time = posChain.addBlock(txs);
-        posTimes.push_back(time);
-        std::cout << "✅ Bloc validé en " << time / 1000.0 << " ms" << std::endl;
+        posTimes.push_back(static_cast<double>(posChain.addBlock(txs)));
     }
     
-    auto posEnd = std::chrono::high_resolution_clock::now();
-    long long posTotal = std::chrono::duration_cast<std::chrono::milliseconds>(posEnd - posStart).count();
+    posChain.displayStageTimes();
+    std::cout << "\n🔎 Validateurs élus recalculés par un autre nœud: "
+              << (posChain.hasElectedValidators() ? "conformes ✓" : "NON CONFORMES ✗") << std::endl;
+    
+    SampleStats pow = SampleStats::of(powTimes);
+    SampleStats pos = SampleStats::of(posTimes);
+    double expectedAttempts = std::pow(16.0, POW_DIFFICULTY);
+    double hashrate = powAttempts * 1e6 / std::max(powTotal, 1.0);
     
     // Afficher les résultats
+    auto ms = [](double micros) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3) << micros / 1000.0 << " ms";
+        return out.str();
+    };
+    auto meanWithInterval = [&](const SampleStats& st) { return ms(st.mean) + " ± " + ms(st.ci95); };
+    std::ostringstream rate, work;
+    rate << std::fixed << std::setprecision(0) << hashrate << " H/s";
+    work << std::fixed << std::setprecision(2) << powAttempts / NUM_BLOCKS / expectedAttempts
+         << " × 16^" << POW_DIFFICULTY << " essais/bloc";
+    
     std::cout << "\n\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
     std::cout << "║              RÉSULTATS DE LA COMPARAISON                     ║" << std::endl;
     std::cout << "╠══════════════════════════════════════════════════════════════╣" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
-    std::cout << "║  PROOF OF WORK:                                              ║" << std::endl;
-    std::cout << "║    Temps total: " << std::setw(43) << std::left << (std::to_string(powTotal) + " ms") << "║" << std::endl;
-    std::cout << "║    Temps moyen/bloc: " << std::setw(38) << std::left << (std::to_string(powTotal/NUM_BLOCKS) + " ms") << "║" << std::endl;
+    std::cout << "║  " << padDisplay("PROOF OF WORK (" + std::to_string(NUM_BLOCKS) + " blocs):", 60) << "║" << std::endl;
+    std::cout << "║    Temps moyen/bloc: " << padDisplay(meanWithInterval(pow), 40) << "║" << std::endl;
+    std::cout << "║    Médiane / p99: " << padDisplay(ms(pow.median) + " / " + ms(pow.p99), 43) << "║" << std::endl;
+    std::cout << "║    Hashrate: " << padDisplay(rate.str(), 48) << "║" << std::endl;
+    std::cout << "║    Travail: " << padDisplay(work.str(), 49) << "║" << std::endl;
     std::cout << "║    Énergie: ⚡⚡⚡⚡⚡ (TRÈS ÉLEVÉE)                            ║" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
-    std::cout << "║  PROOF OF STAKE:                                             ║" << std::endl;
-    std::cout << "║    Temps total: " << std::setw(43) << std::left << (std::to_string(posTotal) + " ms") << "║" << std::endl;
-    std::cout << "║    Temps moyen/bloc: " << std::setw(38) << std::left << (std::to_string(posTotal/NUM_BLOCKS) + " ms") << "║" << std::endl;
+    std::cout << "║  " << padDisplay("PROOF OF STAKE (" + std::to_string(NUM_BLOCKS) + " blocs):", 60) << "║" << std::endl;
+    std::cout << "║    Temps moyen/bloc: " << padDisplay(meanWithInterval(pos), 40) << "║" << std::endl;
+    std::cout << "║    Médiane / p99: " << padDisplay(ms(pos.median) + " / " + ms(pos.p99), 43) << "║" << std::endl;
     std::cout << "║    Énergie: ⚡ (TRÈS FAIBLE)                                 ║" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
     std::cout << "╠══════════════════════════════════════════════════════════════╣" << std::endl;
     
-    double speedup = static_cast<double>(powTotal) / posTotal;
+    // Rapport des médianes: peu sensible aux blocs exceptionnellement longs
+    double speedup = pow.median / std::max(pos.median, 1.0);
     std::cout << "║  CONCLUSION:                                                 ║" << std::endl;
-    std::cout << "║    PoS est " << std::setw(47) << std::left << (std::to_string(static_cast<int>(speedup)) + "x plus RAPIDE que PoW") << "║" << std::endl;
+    std::cout << "║    PoS est "
+              << padDisplay(std::to_string(static_cast<int>(speedup)) + "x plus RAPIDE que PoW (médianes)", 50)
+              << "║" << std::endl;
     std::cout << "║    PoS consomme ~99.9% MOINS d'énergie que PoW               ║" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
     std::cout << "╚══════════════════════════════════════════════════════════════╝" << std::endl;
-    
-    // Détails par bloc
-    std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
-    std::cout << "║           TEMPS DÉTAILLÉ PAR BLOC (en ms)                    ║" << std::endl;
-    std::cout << "╠══════════════╦═══════════════════╦═════════════════════════╣" << std::endl;
-    std::cout << "║    Bloc      ║   PoW (mining)    ║   PoS (validation)      ║" << std::endl;
-    std::cout << "╠══════════════╬═══════════════════╬═════════════════════════╣" << std::endl;
-    
-    for (int i = 0; i < NUM_BLOCKS; i++) {
-        std::cout << "║      " << std::setw(2) << (i+1) << "      ║  " 
-                  << std::setw(16) << std::right << (powTimes[i]/1000.0) << " ║  "
-                  << std::setw(22) << std::right << (posTimes[i]/1000.0) << " ║" << std::endl;
-    }
-    
-    std::cout << "╚══════════════╩═══════════════════╩═════════════════════════╝" << std::endl;
+    std::cout << "💡 Temps attendu en PoW: 16^" << POW_DIFFICULTY << " / hashrate = "
+              << ms(expectedAttempts / hashrate * 1e6) << " par bloc" << std::endl;
 }
 
 int main() {
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <array>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -8,28 +9,840 @@
 #include <chrono>
 #include <cmath>
 #include <cstdlib>
+#include <cctype>
 #include <algorithm>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <deque>
+#include <map>
+#include <atomic>
+#include <fstream>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <random>
+#include <future>
+#include <limits>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
 
 // ============================================================================
-// PARTIE 0: Fonction de hachage SHA-256 simplifiée
+// PARTIE 0: Fonction de hachage SHA-256 (FIPS 180-4, évaluable à la compilation)
 // ============================================================================
 class SHA256 {
 public:
+    using Digest = std::array<uint8_t, 32>;
+    
+    // Contexte incrémental: permet de hacher plusieurs morceaux sans les
+    // concaténer, y compris dans une expression constexpr
+    class Context {
+    private:
+        uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                             0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        uint8_t buffer[64] = {};
+        size_t buffered = 0;
+        uint64_t totalBytes = 0;
+        
+        static constexpr uint32_t rotr(uint32_t x, uint32_t n) {
+            return (x >> n) | (x << (32 - n));
+        }
+        
+        constexpr void compress(const uint8_t* block) {
+            constexpr uint32_t K[64] = {
+                0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+                0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+                0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+                0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+                0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+                0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+                0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+                0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+            };
+            
+            uint32_t w[64] = {};
+            for (int i = 0; i < 16; i++) {
+                w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+                       (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+            }
+            for (int i = 16; i < 64; i++) {
+                uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            
+            for (int i = 0; i < 64; i++) {
+                uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+                uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+            
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+        
+        template <typename Byte>
+        constexpr Context& absorb(const Byte* data, size_t len) {
+            totalBytes += len;
+            for (size_t i = 0; i < len; i++) {
+                buffer[buffered++] = static_cast<uint8_t>(data[i]);
+                if (buffered == 64) {
+                    compress(buffer);
+                    buffered = 0;
+                }
+            }
+            return *this;
+        }
+        
+    public:
+        constexpr Context() {}
+        
+        constexpr Context& update(const char* data, size_t len) {
+            return absorb(data, len);
+        }
+        
+        constexpr Context& update(const uint8_t* data, size_t len) {
+            return absorb(data, len);
+        }
+        
+        // Chaîne C terminée par '\0' (longueur calculée, utilisable en constexpr)
+        constexpr Context& update(const char* str) {
+            size_t len = 0;
+            while (str[len] != '\0') len++;
+            return update(str, len);
+        }
+        
+        // Ajoute un entier non signé sous sa forme décimale (comme operator<<)
+        constexpr Context& updateDecimal(uint64_t value) {
+            char digits[20] = {};
+            size_t n = 0;
+            do {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            for (size_t i = 0; i < n / 2; i++) {
+                char tmp = digits[i];
+                digits[i] = digits[n - 1 - i];
+                digits[n - 1 - i] = tmp;
+            }
+            return update(digits, n);
+        }
+        
+        // Ajoute un digest sous sa forme hexadécimale (comme SHA256::toHex)
+        constexpr Context& updateHex(const Digest& d) {
+            constexpr char digits[] = "0123456789abcdef";
+            for (size_t i = 0; i < d.size(); i++) {
+                const char pair[2] = {digits[d[i] >> 4], digits[d[i] & 0x0f]};
+                update(pair, 2);
+            }
+            return *this;
+        }
+        
+        constexpr Digest finish() {
+            uint64_t bitLength = totalBytes * 8;
+            const char pad = static_cast<char>(0x80);
+            const char zero = 0;
+            update(&pad, 1);
+            while (buffered != 56) {
+                update(&zero, 1);
+            }
+            for (int i = 7; i >= 0; i--) {
+                const char byte = static_cast<char>((bitLength >> (8 * i)) & 0xff);
+                update(&byte, 1);
+            }
+            
+            Digest out = {};
+            for (int i = 0; i < 8; i++) {
+                out[4 * i]     = static_cast<uint8_t>(state[i] >> 24);
+                out[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+                out[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+                out[4 * i + 3] = static_cast<uint8_t>(state[i]);
+            }
+            return out;
+        }
+    };
+    
+    static constexpr Digest digest(const char* data, size_t len) {
+        return Context().update(data, len).finish();
+    }
+    
+    static constexpr Digest digest(const uint8_t* data, size_t len) {
+        return Context().update(data, len).finish();
+    }
+    
+    template <size_t N>
+    static constexpr Digest digest(const char (&literal)[N]) {
+        return digest(literal, N - 1);
+    }
+    
+    // Conversion hexadécimale constexpr (utilisée pour les vecteurs de test).
+    // Lit 64 caractères sans contrôle: pour une chaîne externe, voir parseHex.
+    static constexpr Digest fromHex(const char* hex) {
+        Digest out = {};
+        for (size_t i = 0; i < 32; i++) {
+            out[i] = static_cast<uint8_t>((nibble(hex[2 * i]) << 4) | nibble(hex[2 * i + 1]));
+        }
+        return out;
+    }
+    
+    // Hash écrit en hexadécimal (64 chiffres exactement); false sinon
+    static bool parseHex(const std::string& hex, Digest& out) {
+        if (hex.size() != 2 * out.size()) return false;
+        for (char c : hex) {
+            if (!std::isxdigit(static_cast<unsigned char>(c))) return false;
+        }
+        out = fromHex(hex.c_str());
+        return true;
+    }
+    
+    static constexpr bool equal(const Digest& a, const Digest& b) {
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+    
+    // Nombre de chiffres hexadécimaux '0' en tête du hash
+    static constexpr int leadingZeroNibbles(const Digest& d) {
+        int count = 0;
+        for (size_t i = 0; i < d.size(); i++) {
+            if ((d[i] >> 4) != 0) return count;
+            count++;
+            if ((d[i] & 0x0f) != 0) return count;
+            count++;
+        }
+        return count;
+    }
+    
+    static std::string toHex(const Digest& d) {
+        static const char* digits = "0123456789abcdef";
+        std::string out(64, '0');
+        for (size_t i = 0; i < d.size(); i++) {
+            out[2 * i]     = digits[d[i] >> 4];
+            out[2 * i + 1] = digits[d[i] & 0x0f];
+        }
+        return out;
+    }
+    
     static std::string hash(const std::string& input) {
-        uint64_t h1 = 0xcbf29ce484222325ULL;
-        uint64_t h2 = 0x6a09e667bb67ae85ULL;
+        return toHex(digest(input.data(), input.size()));
+    }
+    
+private:
+    static constexpr uint8_t nibble(char c) {
+        return static_cast<uint8_t>((c >= 'a') ? (c - 'a' + 10) : (c >= 'A') ? (c - 'A' + 10) : (c - '0'));
+    }
+};
+
+// Vecteurs de test FIPS 180-2, vérifiés à la compilation
+static_assert(SHA256::equal(SHA256::digest(""),
+              SHA256::fromHex("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855")),
+              "SHA-256(\"\") incorrect");
+static_assert(SHA256::equal(SHA256::digest("abc"),
+              SHA256::fromHex("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad")),
+              "SHA-256(\"abc\") incorrect");
+static_assert(SHA256::equal(SHA256::digest("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+              SHA256::fromHex("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1")),
+              "SHA-256(448 bits) incorrect");
+
+// ============================================================================
+// PARTIE 0.1: Signatures Ed25519 (RFC 8032), sans dépendance externe
+// ============================================================================
+
+// SHA-512 (FIPS 180-4), requis par Ed25519
+class SHA512 {
+public:
+    using Digest = std::array<uint8_t, 64>;
+    
+    class Context {
+    private:
+        uint64_t state[8];
+        uint8_t buffer[128];
+        size_t bufferLength;
+        uint64_t totalLength;
+        
+        static uint64_t rotr(uint64_t x, int n) { return (x >> n) | (x << (64 - n)); }
+        
+        void transform(const uint8_t* block) {
+            static const uint64_t K[80] = {
+                0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+                0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+                0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+                0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+                0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+                0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+                0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+                0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+                0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+                0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+                0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+                0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+                0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+                0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+                0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+                0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+                0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+                0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+                0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+                0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+            };
+            
+            uint64_t w[80];
+            for (int i = 0; i < 16; i++) {
+                w[i] = 0;
+                for (int j = 0; j < 8; j++) w[i] = (w[i] << 8) | block[i * 8 + j];
+            }
+            for (int i = 16; i < 80; i++) {
+                uint64_t s0 = rotr(w[i - 15], 1) ^ rotr(w[i - 15], 8) ^ (w[i - 15] >> 7);
+                uint64_t s1 = rotr(w[i - 2], 19) ^ rotr(w[i - 2], 61) ^ (w[i - 2] >> 6);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            
+            uint64_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint64_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int i = 0; i < 80; i++) {
+                uint64_t t1 = h + (rotr(e, 14) ^ rotr(e, 18) ^ rotr(e, 41)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+                uint64_t t2 = (rotr(a, 28) ^ rotr(a, 34) ^ rotr(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+    
+    public:
+        Context() : state{0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+                          0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+                          0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL},
+                    buffer{}, bufferLength(0), totalLength(0) {}
+        
+        Context& update(const uint8_t* data, size_t len) {
+            totalLength += len;
+            while (len > 0) {
+                size_t take = std::min(len, sizeof(buffer) - bufferLength);
+                std::copy(data, data + take, buffer + bufferLength);
+                bufferLength += take;
+                data += take;
+                len -= take;
+                if (bufferLength == sizeof(buffer)) {
+                    transform(buffer);
+                    bufferLength = 0;
+                }
+            }
+            return *this;
+        }
+        
+        Digest finish() {
+            uint64_t bits = totalLength * 8;
+            uint8_t pad = 0x80;
+            update(&pad, 1);
+            uint8_t zero = 0;
+            while (bufferLength != 112) update(&zero, 1);
+            uint8_t length[16] = {};
+            for (int i = 0; i < 8; i++) length[15 - i] = static_cast<uint8_t>(bits >> (8 * i));
+            update(length, sizeof(length));
+            
+            Digest out;
+            for (int i = 0; i < 8; i++) {
+                for (int j = 0; j < 8; j++) out[i * 8 + j] = static_cast<uint8_t>(state[i] >> (56 - 8 * j));
+            }
+            return out;
+        }
+    };
+    
+    static Digest digest(const uint8_t* data, size_t len) {
+        return Context().update(data, len).finish();
+    }
+};
+
+// Ed25519 sur la courbe d'Edwards tordue -x² + y² = 1 + d·x²·y² modulo
+// p = 2^255 - 19. Éléments du corps en 5 limbes de 51 bits, points en
+// coordonnées étendues (X:Y:Z:T). La vérification est cofactorisée ([8]·),
+// ce qui rend la vérification individuelle et la vérification par lot
+// équivalentes. Les multiplications scalaires ne sont pas à temps constant:
+// les clés de démonstration sont dérivées de noms publics.
+class Ed25519 {
+public:
+    using PublicKey = std::array<uint8_t, 32>;
+    using Signature = std::array<uint8_t, 64>;
+    using Scalar = std::array<uint8_t, 32>;    // little-endian, réduit modulo L
+    
+    struct KeyPair {
+        Scalar secret;          // scalaire "clampé" a
+        std::array<uint8_t, 32> prefix;
+        PublicKey publicKey;    // [a]B encodé
+    };
+    
+    // Signature à vérifier; le message est désigné, pas copié
+    struct BatchItem {
+        const uint8_t* message;
+        size_t length;
+        PublicKey publicKey;
+        Signature signature;
+    };
+
+private:
+    using u128 = unsigned __int128;
+    static constexpr uint64_t MASK51 = (1ULL << 51) - 1;
+    
+    struct Fe {
+        uint64_t v[5];
+    };
+    
+    struct Point {
+        Fe X, Y, Z, T;
+    };
+    
+    // Forme précalculée pour l'addition: (Y+X, Y-X, 2Z, 2d·T)
+    struct Cached {
+        Fe YplusX, YminusX, Z2, T2d;
+    };
+    
+    // ---------- Corps GF(2^255 - 19) ----------
+    
+    static Fe feZero() { return Fe{{0, 0, 0, 0, 0}}; }
+    static Fe feOne() { return Fe{{1, 0, 0, 0, 0}}; }
+    
+    static void feCarry(Fe& h) {
+        uint64_t c;
+        c = h.v[0] >> 51; h.v[0] &= MASK51; h.v[1] += c;
+        c = h.v[1] >> 51; h.v[1] &= MASK51; h.v[2] += c;
+        c = h.v[2] >> 51; h.v[2] &= MASK51; h.v[3] += c;
+        c = h.v[3] >> 51; h.v[3] &= MASK51; h.v[4] += c;
+        c = h.v[4] >> 51; h.v[4] &= MASK51; h.v[0] += c * 19;
+    }
+    
+    static Fe feAdd(const Fe& f, const Fe& g) {
+        Fe h;
+        for (int i = 0; i < 5; i++) h.v[i] = f.v[i] + g.v[i];
+        feCarry(h);
+        return h;
+    }
+    
+    // f - g + 4p pour rester positif
+    static Fe feSub(const Fe& f, const Fe& g) {
+        Fe h;
+        h.v[0] = f.v[0] + 0x1fffffffffffb4ULL - g.v[0];
+        for (int i = 1; i < 5; i++) h.v[i] = f.v[i] + 0x1ffffffffffffcULL - g.v[i];
+        feCarry(h);
+        return h;
+    }
+    
+    static Fe feNeg(const Fe& f) { return feSub(feZero(), f); }
+    
+    static Fe feMul(const Fe& f, const Fe& g) {
+        uint64_t g1 = g.v[1] * 19, g2 = g.v[2] * 19, g3 = g.v[3] * 19, g4 = g.v[4] * 19;
+        u128 r0 = (u128)f.v[0] * g.v[0] + (u128)f.v[1] * g4 + (u128)f.v[2] * g3 + (u128)f.v[3] * g2 + (u128)f.v[4] * g1;
+        u128 r1 = (u128)f.v[0] * g.v[1] + (u128)f.v[1] * g.v[0] + (u128)f.v[2] * g4 + (u128)f.v[3] * g3 + (u128)f.v[4] * g2;
+        u128 r2 = (u128)f.v[0] * g.v[2] + (u128)f.v[1] * g.v[1] + (u128)f.v[2] * g.v[0] + (u128)f.v[3] * g4 + (u128)f.v[4] * g3;
+        u128 r3 = (u128)f.v[0] * g.v[3] + (u128)f.v[1] * g.v[2] + (u128)f.v[2] * g.v[1] + (u128)f.v[3] * g.v[0] + (u128)f.v[4] * g4;
+        u128 r4 = (u128)f.v[0] * g.v[4] + (u128)f.v[1] * g.v[3] + (u128)f.v[2] * g.v[2] + (u128)f.v[3] * g.v[1] + (u128)f.v[4] * g.v[0];
+        
+        Fe h;
+        r1 += (uint64_t)(r0 >> 51); h.v[0] = (uint64_t)r0 & MASK51;
+        r2 += (uint64_t)(r1 >> 51); h.v[1] = (uint64_t)r1 & MASK51;
+        r3 += (uint64_t)(r2 >> 51); h.v[2] = (uint64_t)r2 & MASK51;
+        r4 += (uint64_t)(r3 >> 51); h.v[3] = (uint64_t)r3 & MASK51;
+        uint64_t c = (uint64_t)(r4 >> 51); h.v[4] = (uint64_t)r4 & MASK51;
+        h.v[0] += c * 19;
+        c = h.v[0] >> 51; h.v[0] &= MASK51; h.v[1] += c;
+        return h;
+    }
+    
+    static Fe feSq(const Fe& f) { return feMul(f, f); }
+    
+    static Fe feSqN(Fe f, int n) {
+        for (int i = 0; i < n; i++) f = feSq(f);
+        return f;
+    }
+    
+    // z^(p-2) (chaîne d'additions de ref10)
+    static Fe feInvert(const Fe& z) {
+        Fe t0 = feSq(z);
+        Fe t1 = feMul(z, feSqN(t0, 2));
+        t0 = feMul(t0, t1);
+        Fe t2 = feSq(t0);
+        t1 = feMul(t1, t2);
+        t1 = feMul(feSqN(t1, 5), t1);
+        t2 = feMul(feSqN(t1, 10), t1);
+        Fe t3 = feMul(feSqN(t2, 20), t2);
+        t2 = feMul(feSqN(t3, 10), t1);
+        t3 = feMul(feSqN(t2, 50), t2);
+        Fe t4 = feMul(feSqN(t3, 100), t3);
+        t3 = feMul(feSqN(t4, 50), t2);
+        return feMul(feSqN(t3, 5), t0);
+    }
+    
+    // z^((p-5)/8), pour la racine carrée de la décompression
+    static Fe fePow22523(const Fe& z) {
+        Fe t0 = feSq(z);
+        Fe t1 = feMul(z, feSqN(t0, 2));
+        t0 = feMul(t0, t1);
+        t0 = feMul(t1, feSq(t0));
+        t1 = feMul(feSqN(t0, 5), t0);
+        Fe t2 = feMul(feSqN(t1, 10), t1);
+        Fe t3 = feMul(feSqN(t2, 20), t2);
+        t2 = feMul(feSqN(t3, 10), t1);
+        t3 = feMul(feSqN(t2, 50), t2);
+        Fe t4 = feMul(feSqN(t3, 100), t3);
+        t3 = feMul(feSqN(t4, 50), t2);
+        return feMul(feSqN(t3, 2), z);
+    }
+    
+    static uint64_t load64(const uint8_t* s) {
+        uint64_t r = 0;
+        for (int i = 7; i >= 0; i--) r = (r << 8) | s[i];
+        return r;
+    }
+    
+    static Fe feFromBytes(const uint8_t* s) {
+        Fe h;
+        h.v[0] = load64(s) & MASK51;
+        h.v[1] = (load64(s + 6) >> 3) & MASK51;
+        h.v[2] = (load64(s + 12) >> 6) & MASK51;
+        h.v[3] = (load64(s + 19) >> 1) & MASK51;
+        h.v[4] = (load64(s + 24) >> 12) & MASK51;
+        return h;
+    }
+    
+    // Représentation canonique (< p) sur 32 octets
+    static std::array<uint8_t, 32> feToBytes(Fe h) {
+        feCarry(h);
+        feCarry(h);
+        uint64_t q = (h.v[0] + 19) >> 51;
+        q = (h.v[1] + q) >> 51;
+        q = (h.v[2] + q) >> 51;
+        q = (h.v[3] + q) >> 51;
+        q = (h.v[4] + q) >> 51;
+        h.v[0] += 19 * q;
+        uint64_t c;
+        c = h.v[0] >> 51; h.v[0] &= MASK51; h.v[1] += c;
+        c = h.v[1] >> 51; h.v[1] &= MASK51; h.v[2] += c;
+        c = h.v[2] >> 51; h.v[2] &= MASK51; h.v[3] += c;
+        c = h.v[3] >> 51; h.v[3] &= MASK51; h.v[4] += c;
+        h.v[4] &= MASK51;
+        
+        uint64_t words[4] = {
+            h.v[0] | (h.v[1] << 51),
+            (h.v[1] >> 13) | (h.v[2] << 38),
+            (h.v[2] >> 26) | (h.v[3] << 25),
+            (h.v[3] >> 39) | (h.v[4] << 12)
+        };
+        std::array<uint8_t, 32> out;
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 8; j++) out[i * 8 + j] = static_cast<uint8_t>(words[i] >> (8 * j));
+        }
+        return out;
+    }
+    
+    static bool feIsZero(const Fe& f) {
+        auto b = feToBytes(f);
+        uint8_t acc = 0;
+        for (uint8_t x : b) acc |= x;
+        return acc == 0;
+    }
+    
+    static bool feIsNegative(const Fe& f) { return feToBytes(f)[0] & 1; }
+    
+    static bool feEqual(const Fe& f, const Fe& g) { return feIsZero(feSub(f, g)); }
+    
+    // Constantes de la courbe (little-endian)
+    static const Fe& curveD() {
+        static const uint8_t bytes[32] = {
+            0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41, 0x4d, 0x0a, 0x70, 0x00,
+            0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c, 0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52
+        };
+        static const Fe d = feFromBytes(bytes);
+        return d;
+    }
+    
+    static const Fe& curveD2() {
+        static const Fe d2 = feAdd(curveD(), curveD());
+        return d2;
+    }
+    
+    static const Fe& sqrtMinusOne() {
+        static const uint8_t bytes[32] = {
+            0xb0, 0xa0, 0x0e, 0x4a, 0x27, 0x1b, 0xee, 0xc4, 0x78, 0xe4, 0x2f, 0xad, 0x06, 0x18, 0x43, 0x2f,
+            0xa7, 0xd7, 0xfb, 0x3d, 0x99, 0x00, 0x4d, 0x2b, 0x0b, 0xdf, 0xc1, 0x4f, 0x80, 0x24, 0x83, 0x2b
+        };
+        static const Fe s = feFromBytes(bytes);
+        return s;
+    }
+    
+    // ---------- Groupe ----------
+    
+    static Point identity() { return Point{feZero(), feOne(), feOne(), feZero()}; }
+    
+    static Cached toCached(const Point& p) {
+        return Cached{feAdd(p.Y, p.X), feSub(p.Y, p.X), feAdd(p.Z, p.Z), feMul(p.T, curveD2())};
+    }
+    
+    static Point add(const Point& p, const Cached& q) {
+        Fe a = feMul(feSub(p.Y, p.X), q.YminusX);
+        Fe b = feMul(feAdd(p.Y, p.X), q.YplusX);
+        Fe c = feMul(p.T, q.T2d);
+        Fe d = feMul(p.Z, q.Z2);
+        Fe e = feSub(b, a), f = feSub(d, c), g = feAdd(d, c), h = feAdd(b, a);
+        return Point{feMul(e, f), feMul(g, h), feMul(f, g), feMul(e, h)};
+    }
+    
+    static Point dbl(const Point& p) {
+        Fe a = feSq(p.X);
+        Fe b = feSq(p.Y);
+        Fe c = feSq(p.Z);
+        c = feAdd(c, c);
+        Fe h = feAdd(a, b);
+        Fe e = feSub(h, feSq(feAdd(p.X, p.Y)));
+        Fe g = feSub(a, b);
+        Fe f = feAdd(c, g);
+        return Point{feMul(e, f), feMul(g, h), feMul(f, g), feMul(e, h)};
+    }
+    
+    static Point negate(const Point& p) { return Point{feNeg(p.X), p.Y, p.Z, feNeg(p.T)}; }
+    
+    static bool isIdentity(const Point& p) { return feIsZero(p.X) && feEqual(p.Y, p.Z); }
+    
+    static PublicKey encode(const Point& p) {
+        Fe zinv = feInvert(p.Z);
+        Fe x = feMul(p.X, zinv);
+        Fe y = feMul(p.Y, zinv);
+        PublicKey out = feToBytes(y);
+        out[31] ^= static_cast<uint8_t>(feIsNegative(x) << 7);
+        return out;
+    }
+    
+    // Décompression (RFC 8032, 5.1.3); refuse les encodages non canoniques
+    static bool decode(const uint8_t* s, Point& p) {
+        Fe y = feFromBytes(s);
+        auto canonical = feToBytes(y);
+        for (int i = 0; i < 31; i++) if (canonical[i] != s[i]) return false;
+        if (canonical[31] != (s[31] & 0x7f)) return false;
+        
+        Fe y2 = feSq(y);
+        Fe u = feSub(y2, feOne());
+        Fe v = feAdd(feMul(y2, curveD()), feOne());
+        Fe v3 = feMul(feSq(v), v);
+        Fe x = feMul(feMul(u, v3), fePow22523(feMul(feMul(u, v3), feMul(v3, v))));
+        
+        Fe vx2 = feMul(v, feSq(x));
+        if (!feEqual(vx2, u)) {
+            if (!feEqual(vx2, feNeg(u))) return false;
+            x = feMul(x, sqrtMinusOne());
+        }
+        bool sign = (s[31] >> 7) != 0;
+        if (feIsZero(x) && sign) return false;
+        if (feIsNegative(x) != sign) x = feNeg(x);
+        
+        p = Point{x, y, feOne(), feMul(x, y)};
+        return true;
+    }
+    
+    static const Point& basePoint() {
+        static const Point b = [] {
+            uint8_t bytes[32];
+            bytes[0] = 0x58;
+            for (int i = 1; i < 32; i++) bytes[i] = 0x66;
+            Point p;
+            decode(bytes, p);
+            return p;
+        }();
+        return b;
+    }
+    
+    // Multiplication multi-scalaire de Straus: fenêtres de 4 bits, une table
+    // de 16 multiples par point, et les doublements partagés par tous les points
+    static Point multiScalarMul(const std::vector<Scalar>& scalars, const std::vector<Point>& points) {
+        size_t n = points.size();
+        std::vector<std::array<Cached, 16>> tables(n);
+        for (size_t i = 0; i < n; i++) {
+            Point multiple = points[i];
+            tables[i][1] = toCached(multiple);
+            for (int k = 2; k < 16; k++) {
+                multiple = add(multiple, tables[i][1]);
+                tables[i][k] = toCached(multiple);
+            }
+        }
+        
+        Point acc = identity();
+        for (int window = 63; window >= 0; window--) {
+            if (window != 63) {
+                for (int k = 0; k < 4; k++) acc = dbl(acc);
+            }
+            for (size_t i = 0; i < n; i++) {
+                int nibble = (scalars[i][window / 2] >> (4 * (window & 1))) & 0xf;
+                if (nibble) acc = add(acc, tables[i][nibble]);
+            }
+        }
+        return acc;
+    }
+    
+    static Point scalarMulBase(const Scalar& s) {
+        return multiScalarMul({s}, {basePoint()});
+    }
+    
+    // ---------- Scalaires modulo L = 2^252 + 27742317777372353535851937790883648493 ----------
+    
+    // Réduction d'un entier de 64 octets en base 2^8 (algorithme de TweetNaCl)
+    static Scalar reduceLimbs(int64_t x[64]) {
+        static const int64_t L[32] = {
+            0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10
+        };
+        int64_t carry;
+        for (int i = 63; i >= 32; --i) {
+            carry = 0;
+            int j;
+            for (j = i - 32; j < i - 12; ++j) {
+                x[j] += carry - 16 * x[i] * L[j - (i - 32)];
+                carry = (x[j] + 128) >> 8;
+                x[j] -= carry * 256;
+            }
+            x[j] += carry;
+            x[i] = 0;
+        }
+        carry = 0;
+        for (int j = 0; j < 32; j++) {
+            x[j] += carry - (x[31] >> 4) * L[j];
+            carry = x[j] >> 8;
+            x[j] &= 255;
+        }
+        for (int j = 0; j < 32; j++) x[j] -= carry * L[j];
+        Scalar r;
+        for (int i = 0; i < 32; i++) {
+            x[i + 1] += x[i] >> 8;
+            r[i] = static_cast<uint8_t>(x[i] & 255);
+        }
+        return r;
+    }
+    
+    static Scalar reduce(const SHA512::Digest& wide) {
+        int64_t x[64];
+        for (int i = 0; i < 64; i++) x[i] = wide[i];
+        return reduceLimbs(x);
+    }
+    
+    // (a * b + c) mod L
+    static Scalar mulAdd(const Scalar& a, const Scalar& b, const Scalar& c) {
+        int64_t x[64] = {};
+        for (int i = 0; i < 32; i++) x[i] = c[i];
+        for (int i = 0; i < 32; i++) {
+            for (int j = 0; j < 32; j++) x[i + j] += int64_t(a[i]) * b[j];
+        }
+        return reduceLimbs(x);
+    }
+    
+    // s < L (refus des signatures malléables)
+    static bool isCanonicalScalar(const uint8_t* s) {
+        static const uint8_t L[32] = {
+            0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10
+        };
+        for (int i = 31; i >= 0; i--) {
+            if (s[i] != L[i]) return s[i] < L[i];
+        }
+        return false;
+    }
+    
+    // k = H(R || A || M) mod L
+    static Scalar challenge(const uint8_t* r, const PublicKey& a, const uint8_t* message, size_t length) {
+        return reduce(SHA512::Context().update(r, 32).update(a.data(), a.size())
+                                       .update(message, length).finish());
+    }
+    
+    static Point mulByCofactor(Point p) {
+        return dbl(dbl(dbl(p)));
+    }
+
+public:
+    static KeyPair keyPairFromSeed(const std::array<uint8_t, 32>& seed) {
+        SHA512::Digest h = SHA512::digest(seed.data(), seed.size());
+        KeyPair kp;
+        std::copy(h.begin(), h.begin() + 32, kp.secret.begin());
+        kp.secret[0] &= 248;
+        kp.secret[31] &= 127;
+        kp.secret[31] |= 64;
+        std::copy(h.begin() + 32, h.end(), kp.prefix.begin());
+        kp.publicKey = encode(scalarMulBase(kp.secret));
+        return kp;
+    }
+    
+    static Signature sign(const KeyPair& kp, const uint8_t* message, size_t length) {
+        Scalar r = reduce(SHA512::Context().update(kp.prefix.data(), kp.prefix.size())
+                                           .update(message, length).finish());
+        PublicKey encodedR = encode(scalarMulBase(r));
+        Scalar k = challenge(encodedR.data(), kp.publicKey, message, length);
+        Scalar s = mulAdd(k, kp.secret, r);
+        
+        Signature sig;
+        std::copy(encodedR.begin(), encodedR.end(), sig.begin());
+        std::copy(s.begin(), s.end(), sig.begin() + 32);
+        return sig;
+    }
+    
+    // [8]([S]B - [k]A - R) = 0
+    static bool verify(const PublicKey& publicKey, const uint8_t* message, size_t length,
+                       const Signature& sig) {
+        BatchItem item{message, length, publicKey, sig};
+        return verifyBatch(&item, 1, 0);
+    }
+    
+    // Équation de lot: [8]( Σ[z_i]R_i + Σ[z_i·k_i]A_i - [Σ z_i·S_i]B ) = 0 avec
+    // des coefficients z_i aléatoires de 128 bits tirés depuis `seed`. Un seul
+    // passage de Straus pour tout le lot; un échec ne dit pas quelle
+    // signature est fausse (il faut alors les vérifier une à une).
+    static bool verifyBatch(const BatchItem* items, size_t count, uint64_t seed) {
+        if (count == 0) return true;
         
-        for (char c : input) {
-            h1 = (h1 ^ static_cast<uint64_t>(c)) * 0x100000001b3ULL;
-            h2 = (h2 * 33) ^ static_cast<uint64_t>(c);
+        std::vector<Scalar> scalars;
+        std::vector<Point> points;
+        scalars.reserve(2 * count + 1);
+        points.reserve(2 * count + 1);
+        Scalar sumS = {};
+        std::mt19937_64 rng(seed);
+        
+        for (size_t i = 0; i < count; i++) {
+            const BatchItem& item = items[i];
+            Point a, r;
+            if (!isCanonicalScalar(item.signature.data() + 32)) return false;
+            if (!decode(item.publicKey.data(), a) || !decode(item.signature.data(), r)) return false;
+            
+            // Une signature seule n'a pas besoin de coefficient aléatoire
+            Scalar z = {};
+            if (count == 1) {
+                z[0] = 1;
+            } else {
+                for (int half = 0; half < 2; half++) {
+                    uint64_t word = rng();
+                    for (int b = 0; b < 8; b++) z[half * 8 + b] = static_cast<uint8_t>(word >> (8 * b));
+                }
+            }
+            
+            Scalar s;
+            std::copy(item.signature.begin() + 32, item.signature.end(), s.begin());
+            Scalar k = challenge(item.signature.data(), item.publicKey, item.message, item.length);
+            
+            sumS = mulAdd(z, s, sumS);
+            scalars.push_back(z);
+            points.push_back(r);
+            scalars.push_back(mulAdd(z, k, Scalar{}));
+            points.push_back(a);
         }
         
-        std::stringstream ss;
-        ss << std::hex << std::setfill('0') 
-           << std::setw(16) << h1 
-           << std::setw(16) << h2;
-        return ss.str();
+        scalars.push_back(sumS);
+        points.push_back(negate(basePoint()));
+        return isIdentity(mulByCofactor(multiScalarMul(scalars, points)));
     }
 };
 
@@ -37,425 +850,4939 @@ public:
 // PARTIE 1: Structure des transactions et Merkle Tree
 // ============================================================================
 
+// Référence à une sortie de transaction: (hash de la transaction, numéro de sortie)
+struct OutPoint {
+    SHA256::Digest txid = {};
+    uint32_t index = 0;
+    
+    bool isNull() const { return index == 0 && SHA256::equal(txid, SHA256::Digest{}); }
+    bool operator==(const OutPoint& other) const {
+        return index == other.index && SHA256::equal(txid, other.txid);
+    }
+};
+
+// Fonction de hachage pour indexer par digest: ses octets sont déjà
+// uniformément distribués, les 8 premiers suffisent
+struct DigestHash {
+    size_t operator()(const SHA256::Digest& d) const {
+        uint64_t h = 0;
+        for (int i = 0; i < 8; i++) h = (h << 8) | d[i];
+        return static_cast<size_t>(h);
+    }
+};
+
+// Montants en unités de base entières (centièmes de coin): aucun flottant
+// n'intervient dans le consensus
+using Amount = int64_t;
+constexpr Amount COIN = 100;
+
+// Émission maximale d'un bloc (sans les frais, que son producteur encaisse aussi)
+constexpr Amount BLOCK_SUBSIDY = 100 * COIN;
+
+inline std::string formatAmount(Amount value) {
+    std::string sign = (value < 0) ? "-" : "";
+    uint64_t magnitude = (value < 0) ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    std::string cents = std::to_string(magnitude % COIN);
+    return sign + std::to_string(magnitude / COIN) + "." + (cents.size() < 2 ? "0" : "") + cents;
+}
+
+// Portefeuille de démonstration: la clé Ed25519 d'un compte est dérivée de
+// son nom (graine = SHA-256 du nom), donc connue de tous. Un vrai nœud ne
+// détiendrait que ses propres graines, tirées au hasard.
+class Wallet {
+public:
+    static const Ed25519::KeyPair& keyFor(const std::string& name) {
+        static std::unordered_map<std::string, Ed25519::KeyPair> keys;
+        static std::mutex keysMutex;
+        
+        std::lock_guard<std::mutex> lock(keysMutex);
+        auto it = keys.find(name);
+        if (it == keys.end()) {
+            it = keys.emplace(name, Ed25519::keyPairFromSeed(SHA256::digest(name.data(), name.size()))).first;
+        }
+        return it->second;
+    }
+};
+
+// Adresse à largeur fixe (20 octets). Celle d'un compte signataire est le
+// début du SHA-256 de sa clé publique; fromName donne l'adresse d'un compte
+// sans clé (genesis, comptes synthétiques). Les noms ne servent qu'à
+// l'affichage (carnet d'adresses local).
+struct Address {
+    static constexpr size_t SIZE = 20;
+    std::array<uint8_t, SIZE> bytes = {};
+    
+    static constexpr Address fromHash(const SHA256::Digest& d) {
+        Address a;
+        for (size_t i = 0; i < SIZE; i++) a.bytes[i] = d[i];
+        return a;
+    }
+    
+    static constexpr Address fromName(const char* name, size_t len) {
+        return fromHash(SHA256::digest(name, len));
+    }
+    
+    static constexpr Address fromName(const char* name) {
+        size_t len = 0;
+        while (name[len] != '\0') len++;
+        return fromName(name, len);
+    }
+    
+    static Address fromPublicKey(const Ed25519::PublicKey& key) {
+        return fromHash(SHA256::digest(key.data(), key.size()));
+    }
+    
+    // Adresse du compte signataire `name`, enregistrée dans le carnet
+    static Address named(const std::string& name) {
+        Address a = fromPublicKey(Wallet::keyFor(name).publicKey);
+        remember(a, name);
+        return a;
+    }
+    
+    static void remember(const Address& a, const std::string& name) {
+        std::lock_guard<std::mutex> lock(bookMutex());
+        book().emplace(a, name);
+    }
+    
+    // Nom connu, sinon préfixe hexadécimal
+    std::string toString() const {
+        {
+            std::lock_guard<std::mutex> lock(bookMutex());
+            auto it = book().find(*this);
+            if (it != book().end()) return it->second;
+        }
+        static const char* HEX = "0123456789abcdef";
+        std::string s = "0x";
+        for (size_t i = 0; i < 4; i++) {
+            s += HEX[bytes[i] >> 4];
+            s += HEX[bytes[i] & 0xf];
+        }
+        return s + "…";
+    }
+    
+    constexpr bool operator==(const Address& other) const {
+        for (size_t i = 0; i < SIZE; i++) {
+            if (bytes[i] != other.bytes[i]) return false;
+        }
+        return true;
+    }
+    constexpr bool operator!=(const Address& other) const { return !(*this == other); }
+    
+    // Les octets sont déjà uniformément distribués
+    struct Hash {
+        size_t operator()(const Address& a) const {
+            uint64_t h = 0;
+            for (int i = 0; i < 8; i++) h = (h << 8) | a.bytes[i];
+            return static_cast<size_t>(h);
+        }
+    };
+    
+private:
+    static std::unordered_map<Address, std::string, Hash>& book() {
+        static std::unordered_map<Address, std::string, Hash> names;
+        return names;
+    }
+    static std::mutex& bookMutex() {
+        static std::mutex m;
+        return m;
+    }
+};
+
+// Modèle UTXO simplifié: une transaction dépense au plus une sortie (input)
+// appartenant à l'émetteur et crée la sortie 0 (destinataire, montant) et la
+// sortie 1 (monnaie rendue à l'émetteur: valeur de l'input - montant - frais).
+// Une transaction sans input est une émission (coinbase).
+//
+// Structure compacte sans allocation et immuable: le hash porte sur
+// l'encodage binaire du corps (96 octets) et il est calculé une seule fois,
+// à la construction, puis conservé dans la transaction. La signature n'en
+// fait pas partie (voir TransactionWitness): les passes sur l'état (UTXO,
+// soldes, Merkle, index) ne lisent que ces 128 octets.
 class Transaction {
+public:
+    static constexpr size_t BODY_SIZE = 96;
+    static constexpr size_t SERIALIZED_SIZE = BODY_SIZE + 32 + 64;   // corps + clé + signature
+    
 private:
-    std::string id;
-    std::string sender;
-    std::string receiver;
-    double amount;
+    Amount amount;
+    Amount fee;
+    Address sender;
+    Address receiver;
+    OutPoint input;
+    uint32_t id;
+    SHA256::Digest txid;
     
 public:
-    Transaction(const std::string& i, const std::string& s, 
-                const std::string& r, double a)
-        : id(i), sender(s), receiver(r), amount(a) {}
+    constexpr Transaction(uint32_t i, const Address& s, const Address& r,
+                          Amount a, Amount f = 0, const OutPoint& in = OutPoint())
+        : amount(a), fee(f), sender(s), receiver(r), input(in), id(i), txid() {
+        auto bytes = serialize();
+        txid = SHA256::digest(bytes.data(), bytes.size());
+    }
+    
+    // Encodage little-endian à largeur fixe du corps:
+    // id(4) | émetteur(20) | destinataire(20) | montant(8) | frais(8) | input(32 + 4)
+    constexpr std::array<uint8_t, BODY_SIZE> serialize() const {
+        std::array<uint8_t, BODY_SIZE> out = {};
+        size_t pos = 0;
+        auto put = [&out, &pos](uint64_t v, int width) {
+            for (int i = 0; i < width; i++) out[pos++] = static_cast<uint8_t>(v >> (8 * i));
+        };
+        put(id, 4);
+        for (uint8_t b : sender.bytes) out[pos++] = b;
+        for (uint8_t b : receiver.bytes) out[pos++] = b;
+        put(static_cast<uint64_t>(amount), 8);
+        put(static_cast<uint64_t>(fee), 8);
+        for (uint8_t b : input.txid) out[pos++] = b;
+        put(input.index, 4);
+        return out;
+    }
+    
+    // Inverse de serialize; le txid est recalculé depuis le corps
+    static Transaction deserialize(const uint8_t* in) {
+        size_t pos = 0;
+        auto get = [in, &pos](int width) {
+            uint64_t v = 0;
+            for (int i = 0; i < width; i++) v |= uint64_t(in[pos++]) << (8 * i);
+            return v;
+        };
+        uint32_t id = static_cast<uint32_t>(get(4));
+        Address sender, receiver;
+        for (uint8_t& b : sender.bytes) b = in[pos++];
+        for (uint8_t& b : receiver.bytes) b = in[pos++];
+        Amount amount = static_cast<Amount>(get(8));
+        Amount fee = static_cast<Amount>(get(8));
+        OutPoint input;
+        for (uint8_t& b : input.txid) b = in[pos++];
+        input.index = static_cast<uint32_t>(get(4));
+        return Transaction(id, sender, receiver, amount, fee, input);
+    }
+    
+    constexpr const SHA256::Digest& getDigest() const { return txid; }
+    
+    // Sortie `index` de cette transaction, à dépenser par une transaction ultérieure
+    OutPoint outPoint(uint32_t index) const {
+        OutPoint out;
+        out.txid = txid;
+        out.index = index;
+        return out;
+    }
+    
+    // Taille sérialisée (en octets, témoin compris), base du calcul du taux de frais
+    size_t getSize() const {
+        return SERIALIZED_SIZE;
+    }
+    
+    std::string getHash() const {
+        return SHA256::toHex(txid);
+    }
+    
+    std::string getLabel() const { return "TX" + std::to_string(id); }
+    
+    void display() const {
+        std::cout << "  [" << getLabel() << "] " << sender.toString() << " → " << receiver.toString()
+                  << " : " << formatAmount(amount) << " coins" << std::endl;
+    }
+    
+    uint32_t getId() const { return id; }
+    const Address& getSender() const { return sender; }
+    const Address& getReceiver() const { return receiver; }
+    Amount getAmount() const { return amount; }
+    Amount getFee() const { return fee; }
+    const OutPoint& getInput() const { return input; }
+    bool isCoinbase() const { return input.isNull(); }
+    
+    // Montant et frais négatifs interdits: une dépense créerait de la monnaie
+    bool hasValidAmounts() const { return amount >= 0 && fee >= 0; }
+};
+
+static_assert(sizeof(Transaction) == Transaction::BODY_SIZE + sizeof(SHA256::Digest),
+              "Transaction doit rester compacte: corps et txid, sans signature");
+
+// Témoin d'une dépense: clé publique de l'émetteur (dont l'adresse doit
+// dériver) et sa signature Ed25519 du txid. Nul pour une émission.
+struct TransactionWitness {
+    Ed25519::PublicKey key = {};
+    Ed25519::Signature signature = {};
+    
+    // L'adresse de l'émetteur dérive-t-elle de la clé fournie? (sans calcul sur la courbe)
+    bool matches(const Transaction& tx) const {
+        return tx.isCoinbase() || Address::fromPublicKey(key) == tx.getSender();
+    }
+    
+    // Entrée de vérification par lot (le message signé est le txid)
+    Ed25519::BatchItem itemFor(const Transaction& tx) const {
+        return Ed25519::BatchItem{tx.getDigest().data(), tx.getDigest().size(), key, signature};
+    }
+};
+
+// Transaction accompagnée de son témoin, telle qu'elle circule avant
+// d'entrer dans un bloc (portefeuille, mempool, réseau). Un bloc range
+// corps et témoins dans deux tableaux distincts de son arène.
+class SignedTransaction : public Transaction {
+private:
+    TransactionWitness witness;
+    
+public:
+    // Sans témoin (émission, ou dépense forgée qui sera refusée)
+    SignedTransaction(const Transaction& tx, const TransactionWitness& w = TransactionWitness())
+        : Transaction(tx), witness(w) {}
+    
+    // Une dépense est signée avec la clé du portefeuille de l'émetteur
+    SignedTransaction(uint32_t i, const std::string& s, const std::string& r,
+                      Amount a, Amount f = 0, const OutPoint& in = OutPoint())
+        : Transaction(i, Address::named(s), Address::named(r), a, f, in) {
+        if (!isCoinbase()) witness = signatureOf(*this, Wallet::keyFor(s));
+    }
+    
+    static TransactionWitness signatureOf(const Transaction& tx, const Ed25519::KeyPair& key) {
+        TransactionWitness w;
+        w.key = key.publicKey;
+        w.signature = Ed25519::sign(key, tx.getDigest().data(), tx.getDigest().size());
+        return w;
+    }
+    
+    // Copie signée; le txid ne change pas (la signature est hors du corps)
+    SignedTransaction signedWith(const Ed25519::KeyPair& key) const {
+        return SignedTransaction(*this, signatureOf(*this, key));
+    }
+    
+    const TransactionWitness& getWitness() const { return witness; }
+    bool hasMatchingKey() const { return witness.matches(*this); }
+    Ed25519::BatchItem signatureItem() const { return witness.itemFor(*this); }
+    
+    // Encodage réseau complet (SERIALIZED_SIZE octets): corps | clé | signature
+    static void encode(const Transaction& tx, const TransactionWitness& w, uint8_t* out) {
+        auto body = tx.serialize();
+        std::copy(body.begin(), body.end(), out);
+        std::copy(w.key.begin(), w.key.end(), out + BODY_SIZE);
+        std::copy(w.signature.begin(), w.signature.end(), out + BODY_SIZE + w.key.size());
+    }
+    
+    void encode(uint8_t* out) const { encode(*this, witness, out); }
+    
+    // Inverse d'encode; le txid est recalculé depuis le corps reçu
+    static SignedTransaction decode(const uint8_t* in) {
+        TransactionWitness w;
+        std::copy(in + BODY_SIZE, in + BODY_SIZE + w.key.size(), w.key.begin());
+        std::copy(in + BODY_SIZE + w.key.size(), in + SERIALIZED_SIZE, w.signature.begin());
+        return SignedTransaction(Transaction::deserialize(in), w);
+    }
+};
+
+// Vue non propriétaire sur des transactions et leurs témoins. Les corps sont
+// lus à pas fixe: tableau de Transaction (bloc dans son arène, std::vector)
+// ou partie Transaction d'un vecteur de SignedTransaction. Les témoins
+// viennent d'un tableau à part, ou sont absents (transactions non signées).
+class TransactionSpan {
+public:
+    class Iterator {
+    private:
+        const uint8_t* position;
+        size_t stride;
+        
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Transaction;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Transaction*;
+        using reference = const Transaction&;
+        
+        Iterator(const uint8_t* p, size_t s) : position(p), stride(s) {}
+        
+        const Transaction& operator*() const { return *reinterpret_cast<const Transaction*>(position); }
+        const Transaction* operator->() const { return reinterpret_cast<const Transaction*>(position); }
+        Iterator& operator++() {
+            position += stride;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            position += stride;
+            return previous;
+        }
+        bool operator==(const Iterator& other) const { return position == other.position; }
+        bool operator!=(const Iterator& other) const { return position != other.position; }
+    };
+    
+private:
+    const uint8_t* bodies;
+    size_t bodyStride;
+    const uint8_t* witnesses;     // nullptr: aucune transaction signée
+    size_t witnessStride;
+    size_t count;
+    
+    static const TransactionWitness& noWitness() {
+        static const TransactionWitness empty;
+        return empty;
+    }
+    
+public:
+    TransactionSpan() : bodies(nullptr), bodyStride(sizeof(Transaction)), witnesses(nullptr),
+                        witnessStride(0), count(0) {}
+    
+    TransactionSpan(const Transaction* f, const TransactionWitness* w, size_t n)
+        : bodies(reinterpret_cast<const uint8_t*>(f)), bodyStride(sizeof(Transaction)),
+          witnesses(reinterpret_cast<const uint8_t*>(w)), witnessStride(sizeof(TransactionWitness)), count(n) {}
+    
+    TransactionSpan(const Transaction* f, size_t n) : TransactionSpan(f, nullptr, n) {}
+    TransactionSpan(const std::vector<Transaction>& v) : TransactionSpan(v.data(), nullptr, v.size()) {}
+    
+    TransactionSpan(const SignedTransaction* f, size_t n)
+        : bodies(reinterpret_cast<const uint8_t*>(static_cast<const Transaction*>(f))),
+          bodyStride(sizeof(SignedTransaction)),
+          witnesses(n ? reinterpret_cast<const uint8_t*>(&f->getWitness()) : nullptr),
+          witnessStride(sizeof(SignedTransaction)), count(n) {}
+    
+    TransactionSpan(const std::vector<SignedTransaction>& v) : TransactionSpan(v.data(), v.size()) {}
+    
+    Iterator begin() const { return Iterator(bodies, bodyStride); }
+    Iterator end() const { return Iterator(bodies + count * bodyStride, bodyStride); }
+    const Transaction& operator[](size_t i) const {
+        return *reinterpret_cast<const Transaction*>(bodies + i * bodyStride);
+    }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    
+    const TransactionWitness& witnessAt(size_t i) const {
+        if (!witnesses) return noWitness();
+        return *reinterpret_cast<const TransactionWitness*>(witnesses + i * witnessStride);
+    }
+    
+    SignedTransaction signedAt(size_t i) const { return SignedTransaction((*this)[i], witnessAt(i)); }
+    
+    // Corps seuls (suffisants pour le Merkle Root)
+    std::vector<Transaction> toVector() const { return std::vector<Transaction>(begin(), end()); }
+};
+
+// Merkle Tree binaire: les feuilles sont les hash mémorisés des transactions
+// et chaque nœud est le SHA-256 des 64 octets de ses deux enfants. Construire
+// l'arbre ne re-hache donc aucune transaction.
+class MerkleTree {
+private:
+    SHA256::Digest root;
+    bool empty;
+    
+    static SHA256::Digest combineHashes(const SHA256::Digest& left, const SHA256::Digest& right) {
+        return SHA256::Context()
+            .update(left.data(), left.size())
+            .update(right.data(), right.size())
+            .finish();
+    }
+    
+public:
+    MerkleTree() : root(), empty(true) {}
+    
+    void build(TransactionSpan transactions) {
+        root = SHA256::Digest{};
+        empty = transactions.empty();
+        if (empty) return;
+        
+        std::vector<SHA256::Digest> level;
+        level.reserve(transactions.size());
+        for (const auto& tx : transactions) {
+            level.push_back(tx.getDigest());
+        }
+        
+        // Réduction niveau par niveau, en place (un nœud impair est dupliqué)
+        size_t count = level.size();
+        while (count > 1) {
+            size_t parents = 0;
+            for (size_t i = 0; i < count; i += 2) {
+                const SHA256::Digest& right = (i + 1 < count) ? level[i + 1] : level[i];
+                level[parents++] = combineHashes(level[i], right);
+            }
+            count = parents;
+        }
+        root = level[0];
+    }
+    
+    // Tout à zéro pour un ensemble vide
+    const SHA256::Digest& getRootDigest() const { return root; }
+    std::string getRoot() const { return empty ? "" : SHA256::toHex(root); }
+};
+
+// ============================================================================
+// PARTIE 1.1: Mempool (transactions en attente) et gabarit de bloc
+// ============================================================================
+
+// Les transactions en attente sont indexées par txid et ordonnées par
+// taux de frais (frais / octet). L'ensemble ordonné sert de file de priorité
+// à deux bouts: la meilleure transaction en tête pour assembler un bloc, la
+// moins rentable en queue pour l'éviction quand le plafond mémoire est atteint.
+class Mempool {
+private:
+    // Coût mémoire approximatif d'une entrée en plus de la transaction sérialisée
+    static constexpr size_t ENTRY_OVERHEAD = 192;
+    
+    struct Entry {
+        SignedTransaction tx;
+        double feeRate;
+        uint64_t sequence;
+        size_t size;
+    };
+    
+    struct PriorityKey {
+        double feeRate;
+        uint64_t sequence;
+        SHA256::Digest txid;
+        
+        // Taux décroissant, puis ordre d'arrivée
+        bool operator<(const PriorityKey& other) const {
+            if (feeRate != other.feeRate) return feeRate > other.feeRate;
+            return sequence < other.sequence;
+        }
+    };
+    
+    std::unordered_map<SHA256::Digest, Entry, DigestHash> byId;
+    std::set<PriorityKey> byFeeRate;
+    size_t usedBytes;
+    size_t maxBytes;
+    uint64_t nextSequence;
+    
+    static size_t cost(const Entry& e) { return e.size + ENTRY_OVERHEAD; }
+    
+    void erase(std::unordered_map<SHA256::Digest, Entry, DigestHash>::iterator it) {
+        byFeeRate.erase({it->second.feeRate, it->second.sequence, it->first});
+        usedBytes -= cost(it->second);
+        byId.erase(it);
+    }
+    
+public:
+    explicit Mempool(size_t maxMemoryBytes = 64 * 1024 * 1024)
+        : usedBytes(0), maxBytes(maxMemoryBytes), nextSequence(0) {}
+    
+    // Ajoute une transaction; évince les moins rentables si le plafond est
+    // dépassé. Retourne false si elle est dupliquée, est une émission (seul
+    // le producteur d'un bloc en crée une), a un montant ou des frais
+    // négatifs, ou est elle-même évincée.
+    bool add(const SignedTransaction& tx) {
+        const SHA256::Digest& txid = tx.getDigest();
+        if (byId.count(txid) || tx.isCoinbase() || !tx.hasValidAmounts()) return false;
+        
+        size_t size = tx.getSize();
+        Entry entry{tx, static_cast<double>(tx.getFee()) / size, nextSequence++, size};
+        
+        auto inserted = byId.emplace(txid, std::move(entry)).first;
+        byFeeRate.insert({inserted->second.feeRate, inserted->second.sequence, txid});
+        usedBytes += cost(inserted->second);
+        
+        bool kept = true;
+        while (usedBytes > maxBytes && !byFeeRate.empty()) {
+            auto worst = std::prev(byFeeRate.end());
+            if (SHA256::equal(worst->txid, txid)) kept = false;
+            erase(byId.find(worst->txid));
+        }
+        return kept;
+    }
+    
+    bool remove(const SHA256::Digest& txid) {
+        auto it = byId.find(txid);
+        if (it == byId.end()) return false;
+        erase(it);
+        return true;
+    }
+    
+    // Retire les transactions incluses dans un bloc
+    void removeForBlock(TransactionSpan txs) {
+        for (const auto& tx : txs) {
+            remove(tx.getDigest());
+        }
+    }
+    
+    // Assemble un bloc par taux de frais décroissant jusqu'à maxBlockBytes.
+    // Seules les k premières entrées sont parcourues (plus quelques rejets
+    // consécutifs tolérés quand une transaction ne rentre pas): jamais tout le pool.
+    // Le gabarit reste cohérent: une seule transaction par sortie dépensée (la
+    // mieux payée), et une transaction dont le parent est encore dans le pool
+    // attend qu'il soit choisi pour être placée juste après lui.
+    std::vector<SignedTransaction> buildBlockTemplate(size_t maxBlockBytes,
+                                                      size_t maxConsecutiveMisses = 1000) const {
+        std::vector<SignedTransaction> selected;
+        std::unordered_set<SHA256::Digest, DigestHash> included;
+        std::set<std::pair<SHA256::Digest, uint32_t>> spent;            // sorties déjà dépensées
+        std::unordered_multimap<SHA256::Digest, const Entry*, DigestHash> waiting;   // parent → enfants
+        size_t blockBytes = 0;
+        size_t misses = 0;
+        
+        // Place une entrée puis, à sa suite, ses descendants en attente
+        auto place = [&](const Entry& first) {
+            std::vector<const Entry*> stack = {&first};
+            while (!stack.empty()) {
+                const Entry& entry = *stack.back();
+                stack.pop_back();
+                const OutPoint& input = entry.tx.getInput();
+                if (blockBytes + entry.size > maxBlockBytes) continue;
+                if (!spent.insert({input.txid, input.index}).second) continue;   // conflit
+                
+                selected.push_back(entry.tx);
+                blockBytes += entry.size;
+                included.insert(entry.tx.getDigest());
+                auto children = waiting.equal_range(entry.tx.getDigest());
+                for (auto it = children.first; it != children.second; ++it) stack.push_back(it->second);
+                waiting.erase(children.first, children.second);
+            }
+        };
+        
+        for (auto it = byFeeRate.begin(); it != byFeeRate.end(); ++it) {
+            const Entry& entry = byId.at(it->txid);
+            const SHA256::Digest& parent = entry.tx.getInput().txid;
+            if (byId.count(parent) && !included.count(parent)) {
+                waiting.emplace(parent, &entry);
+                continue;
+            }
+            if (blockBytes + entry.size > maxBlockBytes) {
+                if (++misses >= maxConsecutiveMisses) break;
+                continue;
+            }
+            misses = 0;
+            place(entry);
+            if (maxBlockBytes - blockBytes == 0) break;
+        }
+        
+        return selected;
+    }
+    
+    bool contains(const SHA256::Digest& txid) const { return byId.count(txid) != 0; }
+    
+    const SignedTransaction* find(const SHA256::Digest& txid) const {
+        auto it = byId.find(txid);
+        return it == byId.end() ? nullptr : &it->second.tx;
+    }
+    
+    size_t size() const { return byId.size(); }
+    size_t memoryUsage() const { return usedBytes; }
+};
+
+// ============================================================================
+// PARTIE 1.2: Ensemble UTXO (sorties non dépensées)
+// ============================================================================
+
+// Table à adressage ouvert (sondage linéaire, suppression par décalage
+// arrière, sans pierre tombale): les entrées sont contiguës en mémoire et une
+// recherche ne suit aucun pointeur. Une pièce tient sur 32 octets: montant en
+// centièmes, adresse du propriétaire, hauteur de création.
+class UtxoSet {
+public:
+    struct Coin {
+        Amount value;
+        Address owner;
+        uint32_t height;
+    };
+    
+    // Journal d'annulation d'un bloc: les modifications dans l'ordre où elles
+    // ont eu lieu, rejouées à l'envers pour déconnecter le bloc exactement
+    struct Change {
+        OutPoint key;
+        Coin coin;
+        bool spent;     // true = pièce dépensée, false = pièce créée
+    };
+    
+    struct BlockUndo {
+        std::vector<Change> changes;
+    };
+    
+private:
+    struct Slot {
+        OutPoint key;
+        Coin coin;
+        bool used;
+    };
+    
+    std::vector<Slot> slots;
+    size_t count;
+    
+    // Le txid est déjà uniformément distribué: ses 8 premiers octets suffisent
+    size_t bucketOf(const OutPoint& key) const {
+        uint64_t h = 0;
+        for (int i = 0; i < 8; i++) h = (h << 8) | key.txid[i];
+        h ^= key.index * 0x9e3779b97f4a7c15ULL;
+        return static_cast<size_t>(h) & (slots.size() - 1);
+    }
+    
+    size_t findSlot(const OutPoint& key) const {
+        size_t mask = slots.size() - 1;
+        for (size_t i = bucketOf(key); slots[i].used; i = (i + 1) & mask) {
+            if (slots[i].key == key) return i;
+        }
+        return slots.size();
+    }
+    
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2, Slot{OutPoint(), Coin{0, Address(), 0}, false});
+        old.swap(slots);
+        count = 0;
+        for (const auto& slot : old) {
+            if (slot.used) insert(slot.key, slot.coin);
+        }
+    }
+    
+    bool insert(const OutPoint& key, const Coin& coin) {
+        if ((count + 1) * 10 > slots.size() * 7) grow();   // facteur de charge <= 0,7
+        
+        size_t mask = slots.size() - 1;
+        size_t i = bucketOf(key);
+        for (; slots[i].used; i = (i + 1) & mask) {
+            if (slots[i].key == key) return false;
+        }
+        slots[i] = Slot{key, coin, true};
+        count++;
+        return true;
+    }
+    
+    void eraseAt(size_t i) {
+        size_t mask = slots.size() - 1;
+        slots[i].used = false;
+        count--;
+        
+        // Décale les entrées suivantes du même groupe pour combler le trou
+        for (size_t j = (i + 1) & mask; slots[j].used; j = (j + 1) & mask) {
+            size_t home = bucketOf(slots[j].key);
+            bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+            if (movable) {
+                slots[i] = slots[j];
+                slots[j].used = false;
+                i = j;
+            }
+        }
+    }
+    
+public:
+    explicit UtxoSet(size_t initialCapacity = 1024) : count(0) {
+        size_t capacity = 16;
+        while (capacity < initialCapacity) capacity *= 2;
+        slots.assign(capacity, Slot{OutPoint(), Coin{0, Address(), 0}, false});
+    }
+    
+    // Applique un bloc en une seule passe (recherche + dépense + création).
+    // Une seule émission (transaction sans input) est admise, en tête du
+    // bloc, et elle ne peut créer plus que BLOCK_SUBSIDY plus les frais du
+    // bloc. En cas d'échec (émission invalide, sortie inconnue ou déjà
+    // dépensée, mauvais propriétaire, montant ou frais négatif, fonds
+    // insuffisants), l'ensemble est remis dans son état initial et
+    // failedIndex reçoit la position de la transaction fautive.
+    bool connectBlock(TransactionSpan txs, uint32_t height, BlockUndo& undo,
+                      std::string* reason = nullptr, size_t* failedIndex = nullptr) {
+        undo = BlockUndo();
+        
+        // Précharge les emplacements des inputs avant de les consulter, et
+        // plafonne l'émission aux frais du bloc en plus de BLOCK_SUBSIDY
+        // (somme saturée; les frais négatifs sont refusés plus bas)
+        Amount reward = BLOCK_SUBSIDY;
+        for (const auto& tx : txs) {
+            if (tx.isCoinbase()) continue;
+            __builtin_prefetch(&slots[bucketOf(tx.getInput())]);
+            Amount fee = tx.getFee();
+            if (fee > 0) {
+                reward = (fee > std::numeric_limits<Amount>::max() - reward) ? std::numeric_limits<Amount>::max()
+                                                                              : reward + fee;
+            }
+        }
+        
+        for (size_t position = 0; position < txs.size(); position++) {
+            const Transaction& tx = txs[position];
+            OutPoint created = tx.outPoint(0);
+            Amount amount = tx.getAmount();
+            Amount fee = tx.getFee();
+            Amount change = 0;
+            
+            size_t i = slots.size();
+            const char* error = nullptr;
+            if (!tx.hasValidAmounts()) {
+                error = "montant ou frais négatif";
+            } else if (tx.isCoinbase()) {
+                if (position != 0) error = "émission hors de la tête du bloc";
+                else if (amount > reward) error = "émission supérieure à la récompense du bloc";
+            } else {
+                i = findSlot(tx.getInput());
+                if (i == slots.size()) error = "double dépense ou sortie inconnue";
+                else if (slots[i].coin.owner != tx.getSender()) error = "sortie d'un autre propriétaire";
+                // Sans somme amount + fee: pas de dépassement sur int64
+                else if (fee > slots[i].coin.value || amount > slots[i].coin.value - fee) error = "fonds insuffisants";
+            }
+            
+            if (error) {
+                if (reason) *reason = tx.getLabel() + ": " + error;
+                if (failedIndex) *failedIndex = position;
+                disconnectBlock(undo);
+                undo = BlockUndo();
+                return false;
+            }
+            
+            if (!tx.isCoinbase()) {
+                change = slots[i].coin.value - amount - fee;
+                undo.changes.push_back({slots[i].key, slots[i].coin, true});
+                eraseAt(i);
+            }
+            
+            Coin paid{amount, tx.getReceiver(), height};
+            if (amount > 0 && insert(created, paid)) {
+                undo.changes.push_back({created, paid, false});
+            }
+            created.index = 1;
+            Coin returned{change, tx.getSender(), height};
+            if (change > 0 && insert(created, returned)) {
+                undo.changes.push_back({created, returned, false});
+            }
+        }
+        return true;
+    }
+    
+    // Annule un bloc à l'aide de son journal (ordre inverse)
+    void disconnectBlock(const BlockUndo& undo) {
+        for (auto it = undo.changes.rbegin(); it != undo.changes.rend(); ++it) {
+            if (it->spent) {
+                insert(it->key, it->coin);
+            } else {
+                size_t i = findSlot(it->key);
+                if (i != slots.size()) eraseAt(i);
+            }
+        }
+    }
+    
+    bool contains(const OutPoint& key) const { return findSlot(key) != slots.size(); }
+    size_t size() const { return count; }
+};
+
+// ============================================================================
+// PARTIE 1.3: Filtre de Bloom (txids et adresses d'un bloc)
+// ============================================================================
+
+// Ensemble probabiliste compact: "absent" est certain, "présent" peut être un
+// faux positif avec le taux choisi à la construction. Les clés (txid,
+// adresse) sont déjà uniformément distribuées: leurs 16 premiers octets
+// fournissent les deux hash du double hachage h1 + i·h2. Les bits sont
+// rangés dans une zone fournie par l'appelant (l'arène du bloc).
+class BloomFilter {
+public:
+    static constexpr double DEFAULT_FALSE_POSITIVE_RATE = 0.01;
+    
+    struct Shape {
+        size_t wordCount;
+        uint32_t hashCount;
+    };
+    
+private:
+    uint64_t* words;
+    uint64_t bitCount;
+    uint32_t hashCount;
+    
+    static uint64_t read64(const uint8_t* p) {
+        uint64_t v = 0;
+        for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+        return v;
+    }
+    
+    template <typename Fn>
+    void forEachBit(const uint8_t* key, Fn fn) const {
+        uint64_t h1 = read64(key);
+        uint64_t h2 = read64(key + 8) | 1;
+        for (uint32_t i = 0; i < hashCount; i++) {
+            fn((h1 + i * h2) % bitCount);
+        }
+    }
+    
+    void insertKey(const uint8_t* key) {
+        forEachBit(key, [this](uint64_t bit) { words[bit / 64] |= 1ULL << (bit % 64); });
+    }
+    
+    bool testKey(const uint8_t* key) const {
+        if (bitCount == 0) return false;
+        bool present = true;
+        forEachBit(key, [&](uint64_t bit) {
+            present = present && ((words[bit / 64] >> (bit % 64)) & 1);
+        });
+        return present;
+    }
+    
+public:
+    // m = -n·ln(p) / ln(2)², k = (m / n)·ln(2)
+    static Shape shapeFor(size_t expectedItems, double falsePositiveRate = DEFAULT_FALSE_POSITIVE_RATE) {
+        double n = static_cast<double>(std::max<size_t>(expectedItems, 1));
+        double p = std::min(std::max(falsePositiveRate, 1e-9), 0.5);
+        double ln2 = std::log(2.0);
+        
+        uint64_t m = static_cast<uint64_t>(std::ceil(-n * std::log(p) / (ln2 * ln2)));
+        m = std::max<uint64_t>(64, (m + 63) / 64 * 64);
+        uint32_t k = static_cast<uint32_t>(std::lround(m / n * ln2));
+        return Shape{static_cast<size_t>(m / 64), std::min<uint32_t>(std::max<uint32_t>(k, 1), 30)};
+    }
+    
+    BloomFilter() : words(nullptr), bitCount(0), hashCount(0) {}
+    
+    // `storage` doit contenir shape.wordCount mots; il est remis à zéro
+    BloomFilter(uint64_t* storage, const Shape& shape)
+        : words(storage), bitCount(shape.wordCount * 64), hashCount(shape.hashCount) {
+        std::fill(words, words + shape.wordCount, 0);
+    }
+    
+    void insert(const SHA256::Digest& txid) { insertKey(txid.data()); }
+    void insert(const Address& address) { insertKey(address.bytes.data()); }
+    
+    bool mightContain(const SHA256::Digest& txid) const { return testKey(txid.data()); }
+    bool mightContain(const Address& address) const { return testKey(address.bytes.data()); }
+    
+    size_t memoryUsage() const { return bitCount / 8; }
+    uint32_t getHashCount() const { return hashCount; }
+};
+
+// ============================================================================
+// PARTIE 2: Validateurs pour Proof of Stake
+// ============================================================================
+
+// Tirage d'un validateur proportionnellement à son stake. Les poids sont
+// entiers (stake en centimes) pour que les mises à jour répétées ne fassent
+// pas dériver les sommes partielles.
+//
+// Arbre de Fenwick: tirage et mise à jour d'un stake en O(log n), ajout d'un
+// validateur en O(log n). Remplace le parcours cumulatif en O(n) par bloc.
+class StakeSampler {
+private:
+    std::vector<uint64_t> tree;      // tree[i] = somme des poids de ]i - lowbit(i), i], base 1
+    std::vector<uint64_t> weights;
+    uint64_t total;
+    
+    static size_t lowbit(size_t i) { return i & (~i + 1); }
+    
+public:
+    StakeSampler() : tree(1, 0), total(0) {}
+    
+    static uint64_t weightOf(double stake) {
+        return stake > 0 ? static_cast<uint64_t>(std::llround(stake * COIN)) : 0;
+    }
+    
+    size_t size() const { return weights.size(); }
+    uint64_t totalWeight() const { return total; }
+    uint64_t weightAt(size_t i) const { return weights[i]; }
+    const std::vector<uint64_t>& getWeights() const { return weights; }
+    
+    // Reconstruit l'arbre en O(n) (chaque nœud remonte sa somme à son parent)
+    void assign(const std::vector<uint64_t>& values) {
+        weights = values;
+        tree.assign(values.size() + 1, 0);
+        total = 0;
+        for (size_t i = 1; i < tree.size(); i++) {
+            tree[i] += values[i - 1];
+            total += values[i - 1];
+            size_t parent = i + lowbit(i);
+            if (parent < tree.size()) tree[parent] += tree[i];
+        }
+    }
+    
+    void add(uint64_t weight) {
+        size_t i = weights.size() + 1;
+        weights.push_back(weight);
+        
+        // Le nouveau nœud couvre ]i - lowbit(i), i]: on agrège ses fils
+        uint64_t node = weight;
+        for (size_t step = 1; step < lowbit(i); step <<= 1) {
+            node += tree[i - step];
+        }
+        tree.push_back(node);
+        total += weight;
+    }
+    
+    void update(size_t index, uint64_t weight) {
+        uint64_t old = weights[index];
+        weights[index] = weight;
+        total = total - old + weight;
+        for (size_t i = index + 1; i < tree.size(); i += lowbit(i)) {
+            tree[i] = tree[i] - old + weight;   // arithmétique modulo 2^64, exacte
+        }
+    }
+    
+    // Plus petit indice dont la somme cumulée dépasse target (target < total)
+    size_t find(uint64_t target) const {
+        size_t n = weights.size();
+        size_t pos = 0;
+        size_t step = 1;
+        while (step * 2 <= n) step *= 2;
+        
+        for (; step > 0; step >>= 1) {
+            if (pos + step <= n && tree[pos + step] <= target) {
+                pos += step;
+                target -= tree[pos];
+            }
+        }
+        return pos;
+    }
+    
+    // Indice tiré au sort, ou size() si aucun poids n'est positif
+    template <typename Rng>
+    size_t sample(Rng& rng) const {
+        if (total == 0) return weights.size();
+        return find(std::uniform_int_distribution<uint64_t>(0, total - 1)(rng));
+    }
+};
+
+// Table d'alias de Walker (construction de Vose): tirage en O(1) quand les
+// stakes ne changent pas, au prix d'une reconstruction en O(n) sinon.
+class AliasTable {
+private:
+    std::vector<double> probability;
+    std::vector<uint32_t> alias;
+    
+public:
+    AliasTable() {}
+    
+    explicit AliasTable(const std::vector<uint64_t>& weights) { build(weights); }
+    
+    void build(const std::vector<uint64_t>& weights) {
+        size_t n = weights.size();
+        probability.assign(n, 1.0);
+        alias.assign(n, 0);
+        
+        long double total = 0;
+        for (uint64_t w : weights) total += w;
+        if (n == 0 || total == 0) return;
+        
+        std::vector<double> scaled(n);
+        std::vector<uint32_t> small, large;
+        for (size_t i = 0; i < n; i++) {
+            scaled[i] = static_cast<double>(weights[i] * static_cast<long double>(n) / total);
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+        }
+        
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back(); small.pop_back();
+            uint32_t l = large.back(); large.pop_back();
+            probability[s] = scaled[s];
+            alias[s] = l;
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+            (scaled[l] < 1.0 ? small : large).push_back(l);
+        }
+        // Les restes valent 1 aux erreurs d'arrondi près
+        for (uint32_t i : small) probability[i] = 1.0;
+        for (uint32_t i : large) probability[i] = 1.0;
+    }
+    
+    size_t size() const { return probability.size(); }
+    
+    template <typename Rng>
+    size_t sample(Rng& rng) const {
+        size_t column = std::uniform_int_distribution<size_t>(0, probability.size() - 1)(rng);
+        return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < probability[column]
+            ? column : alias[column];
+    }
+};
+
+// Registre des validateurs en structure de tableaux (SoA): chaque attribut
+// est un tableau contigu indexé par l'identifiant du validateur. Les passes
+// sur tous les validateurs (récompenses, tirage) ne lisent que les tableaux
+// utiles, sans allocation ni indirection par validateur; les noms, froids,
+// ne servent qu'à l'affichage.
+class ValidatorRegistry {
+public:
+    using Id = uint32_t;
+    static constexpr Id NONE = 0xffffffff;
+    
+private:
+    std::vector<Address> addresses;           // identifiants compacts (20 octets)
+    StakeSampler stakes;                      // tableau des stakes (centimes) + arbre de Fenwick
+    std::vector<uint32_t> blocksValidated;
+    std::vector<Amount> rewards;
+    std::vector<std::string> names;
+    std::unordered_map<Address, Id, Address::Hash> index;
+    
+public:
+    size_t size() const { return addresses.size(); }
+    bool empty() const { return addresses.empty(); }
+    
+    void reserve(size_t count) {
+        addresses.reserve(count);
+        blocksValidated.reserve(count);
+        rewards.reserve(count);
+        names.reserve(count);
+        index.reserve(count);
+    }
+    
+    // Inscrit un validateur avec un stake nul (ou renvoie son identifiant).
+    // Un validateur nommé a l'adresse de son portefeuille (Address::named),
+    // celle qui reçoit les paiements à ce nom.
+    Id add(const std::string& name) { return add(Address::named(name), name); }
+    
+    Id add(const Address& address, const std::string& name) {
+        auto found = index.find(address);
+        if (found != index.end()) return found->second;
+        
+        Id id = static_cast<Id>(addresses.size());
+        addresses.push_back(address);
+        stakes.add(0);
+        blocksValidated.push_back(0);
+        rewards.push_back(0);
+        names.push_back(name);
+        index.emplace(address, id);
+        return id;
+    }
+    
+    Id find(const std::string& name) const { return find(Address::named(name)); }
+    
+    Id find(const Address& address) const {
+        auto found = index.find(address);
+        return found == index.end() ? NONE : found->second;
+    }
+    
+    const std::string& nameOf(Id id) const { return names[id]; }
+    const Address& addressOf(Id id) const { return addresses[id]; }
+    uint64_t stakeOf(Id id) const { return stakes.weightAt(id); }
+    uint32_t blocksValidatedBy(Id id) const { return blocksValidated[id]; }
+    Amount rewardOf(Id id) const { return rewards[id]; }
+    uint64_t totalStake() const { return stakes.totalWeight(); }
+    const StakeSampler& getStakes() const { return stakes; }
+    
+    void setStake(Id id, uint64_t weight) { stakes.update(id, weight); }
+    
+    // Changements groupés (frontière d'époque): mises à jour en O(k log n),
+    // ou reconstruction de l'arbre en O(n) quand ils touchent une bonne
+    // partie du registre
+    void applyStakes(const std::vector<std::pair<Id, uint64_t>>& changes) {
+        size_t logSize = 1;
+        while ((size_t(1) << logSize) < size()) logSize++;
+        
+        if (changes.size() * logSize < size()) {
+            for (const auto& change : changes) stakes.update(change.first, change.second);
+            return;
+        }
+        std::vector<uint64_t> weights = stakes.getWeights();
+        for (const auto& change : changes) weights[change.first] = change.second;
+        stakes.assign(weights);
+    }
+    
+    void recordBlock(Id id, Amount fees) {
+        blocksValidated[id]++;
+        rewards[id] += fees;
+    }
+    
+    // Annule recordBlock (bloc retiré de la branche active)
+    void unrecordBlock(Id id, Amount fees) {
+        blocksValidated[id]--;
+        rewards[id] -= fees;
+    }
+    
+    // Répartit pool au prorata des stakes, en une passe sur deux tableaux
+    // contigus (vectorisable). Renvoie le montant distribué: les fractions de
+    // centime tronquées restent dans pool.
+    Amount distributeRewards(Amount pool) {
+        if (stakes.totalWeight() == 0 || pool <= 0) return 0;
+        
+        const uint64_t* weight = stakes.getWeights().data();
+        Amount* reward = rewards.data();
+        double rate = static_cast<double>(pool) / static_cast<double>(stakes.totalWeight());
+        Amount distributed = 0;
+        for (size_t i = 0, n = size(); i < n; i++) {
+            Amount share = static_cast<Amount>(static_cast<double>(weight[i]) * rate);
+            reward[i] += share;
+            distributed += share;
+        }
+        return distributed;
+    }
+    
+    void display(Id id) const {
+        std::cout << "  👤 " << std::setw(15) << std::left << names[id]
+                  << " | Stake: " << std::setw(8) << std::right
+                  << formatAmount(static_cast<Amount>(stakes.weightAt(id)))
+                  << " | Blocs validés: " << blocksValidated[id];
+        if (rewards[id] != 0) std::cout << " | Récompenses: " << formatAmount(rewards[id]);
+        std::cout << std::endl;
+    }
+};
+
+// Élection du producteur d'un créneau (slot): tirage déterministe à partir de
+// SHA256(graine || slot), la graine étant le hash d'un bloc déjà connu. Tout
+// nœud disposant des mêmes stakes retrouve le même élu en O(log n) et peut
+// donc vérifier l'en-tête sans lui faire confiance.
+struct LeaderElection {
+    static SHA256::Digest seedFor(const SHA256::Digest& blockHash, uint32_t slot) {
+        std::array<uint8_t, 36> message = {};
+        std::copy(blockHash.begin(), blockHash.end(), message.begin());
+        for (int i = 0; i < 4; i++) message[32 + i] = static_cast<uint8_t>(slot >> (8 * i));
+        return SHA256::digest(message.data(), message.size());
+    }
+    
+    // Indice de l'élu, ou stakes.size() si aucun stake n'est positif
+    static size_t elect(const StakeSampler& stakes, const SHA256::Digest& blockHash, uint32_t slot) {
+        if (stakes.totalWeight() == 0) return stakes.size();
+        
+        SHA256::Digest seed = seedFor(blockHash, slot);
+        uint64_t draw = 0;
+        for (int i = 0; i < 8; i++) draw |= static_cast<uint64_t>(seed[i]) << (8 * i);
+        // Biais du modulo < total / 2^64, négligeable
+        return stakes.find(draw % stakes.totalWeight());
+    }
+};
+
+// Calendrier d'une époque: le producteur de chacun de ses créneaux, tiré en
+// un seul lot à partir de stakes figés et d'une graine connue d'avance
+struct EpochSchedule {
+    uint32_t epoch;
+    uint32_t firstSlot;
+    uint32_t seedHeight;                           // bloc dont le hash sert de graine
+    std::vector<uint32_t> leaders;                 // leaders[slot - firstSlot]
+    
+    // Élit le validateur de chaque créneau (O(N log n) pour N créneaux)
+    static std::shared_ptr<const EpochSchedule> compute(uint32_t epoch, uint32_t length, uint32_t seedHeight,
+                                                        const SHA256::Digest& seed,
+                                                        std::shared_ptr<const StakeSampler> stakes) {
+        auto schedule = std::make_shared<EpochSchedule>();
+        schedule->epoch = epoch;
+        schedule->firstSlot = epoch * length;
+        schedule->seedHeight = seedHeight;
+        schedule->leaders.resize(length);
+        for (uint32_t i = 0; i < length; i++) {
+            size_t leader = LeaderElection::elect(*stakes, seed, schedule->firstSlot + i);
+            // Aucun stake positif: le premier validateur produit le bloc
+            schedule->leaders[i] = static_cast<uint32_t>(leader < stakes->size() ? leader : 0);
+        }
+        return schedule;
+    }
+    
+    uint32_t leaderOf(uint32_t slot) const { return leaders[slot - firstSlot]; }
+};
+
+// Époques de N créneaux (un créneau = une hauteur de bloc). À l'entrée dans
+// l'époque e, les stakes sont figés et le calendrier de l'époque e+1 est
+// calculé sur un thread d'arrière-plan, avec pour graine le hash du dernier
+// bloc de l'époque e-1: il est prêt bien avant d'être consulté.
+class EpochScheduler {
+public:
+    static constexpr uint32_t DEFAULT_LENGTH = 8;
+    
+private:
+    struct Entry {
+        uint32_t seedHeight;
+        std::shared_future<std::shared_ptr<const EpochSchedule>> schedule;
+    };
+    
+    uint32_t length;
+    std::map<uint32_t, Entry> entries;
+    
+public:
+    explicit EpochScheduler(uint32_t len = DEFAULT_LENGTH) : length(len == 0 ? 1 : len) {}
+    
+    uint32_t getLength() const { return length; }
+    uint32_t epochOf(uint32_t slot) const { return slot / length; }
+    uint32_t firstSlotOf(uint32_t epoch) const { return epoch * length; }
+    bool isStarted() const { return !entries.empty(); }
+    
+    void plan(uint32_t epoch, uint32_t seedHeight, const SHA256::Digest& seed,
+              std::shared_ptr<const StakeSampler> stakes, bool background) {
+        uint32_t len = length;
+        // Les stakes figés sont libérés dès le calendrier calculé
+        auto task = [epoch, len, seedHeight, seed, stakes]() mutable {
+            return EpochSchedule::compute(epoch, len, seedHeight, seed, std::move(stakes));
+        };
+        auto launch = background ? std::launch::async : std::launch::deferred;
+        Entry entry{seedHeight, std::async(launch, task).share()};
+        if (!background) entry.schedule.wait();
+        entries[epoch] = std::move(entry);
+    }
+    
+    // Calendrier de l'époque (attend la fin du calcul si besoin), ou nullptr
+    const EpochSchedule* find(uint32_t epoch) const {
+        auto it = entries.find(epoch);
+        if (it == entries.end()) return nullptr;
+        auto schedule = it->second.schedule;   // copie: get() concurrent sans risque
+        return schedule.get().get();
+    }
+    
+    // Oublie les calendriers dont la graine est un bloc retiré de la chaîne
+    void forgetSeededFrom(uint32_t height) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            it = it->second.seedHeight >= height ? entries.erase(it) : std::next(it);
+        }
+    }
+};
+
+// ============================================================================
+// PARTIE 3: Classe Block (avec PoW et PoS)
+// ============================================================================
+
+// Cible PoW à grain fin: un hash, lu comme un entier de 256 bits big-endian,
+// est valide s'il ne dépasse pas la cible. Encodage compact sur 32 bits à la
+// manière de nBits (Bitcoin): exposant sur 8 bits (taille en octets) et
+// mantisse sur 24 bits, cible = mantisse × 256^(exposant − 3). Sous forme
+// canonique (mantisse ≥ 0x010000), l'ordre des entiers compacts est celui
+// des cibles.
+struct Target {
+    static constexpr uint32_t MAXIMUM = 0x20ffffff;   // ≈ 2^256: tout hash ou presque
+    
+    static constexpr uint32_t exponentOf(uint32_t bits) { return bits >> 24; }
+    static constexpr uint32_t mantissaOf(uint32_t bits) { return bits & 0x00ffffff; }
+    
+    // Forme canonique de mantisse × 256^(exposant − 3), bornée par MAXIMUM
+    static constexpr uint32_t encode(uint64_t mantissa, int exponent) {
+        if (mantissa == 0) mantissa = 1;
+        while (mantissa > 0xffffff) {
+            mantissa >>= 8;
+            exponent++;
+        }
+        while (mantissa < 0x010000 && exponent > 3) {
+            mantissa <<= 8;
+            exponent--;
+        }
+        if (exponent > static_cast<int>(exponentOf(MAXIMUM))) return MAXIMUM;
+        return (static_cast<uint32_t>(exponent) << 24) | static_cast<uint32_t>(mantissa);
+    }
+    
+    // Cible équivalente à d zéros hexadécimaux en tête: 2^(256 − 4d)
+    static constexpr uint32_t fromZeroNibbles(int d) {
+        int log2 = 256 - 4 * std::max(d, 0);
+        if (log2 >= 256) return MAXIMUM;
+        return encode(uint64_t(1) << (log2 % 8 + 16), log2 / 8 + 1);
+    }
+    
+    // Cible sur 256 bits, même ordre d'octets que les hash
+    static constexpr SHA256::Digest expand(uint32_t bits) {
+        SHA256::Digest target = {};
+        int exponent = static_cast<int>(exponentOf(bits));
+        uint32_t mantissa = mantissaOf(bits);
+        for (int i = 0; i < 3; i++) {
+            int pos = 32 - exponent + i;
+            if (pos >= 0 && pos < 32) target[pos] = static_cast<uint8_t>(mantissa >> (8 * (2 - i)));
+        }
+        return target;
+    }
+    
+    static constexpr bool isMetBy(const SHA256::Digest& hash, const SHA256::Digest& target) {
+        for (size_t i = 0; i < hash.size(); i++) {
+            if (hash[i] != target[i]) return hash[i] < target[i];
+        }
+        return true;
+    }
+    
+    // Travail attendu (nombre moyen d'essais): 2^256 / cible, borné à 64 bits
+    static uint64_t work(uint32_t bits) {
+        uint64_t mantissa = std::max<uint64_t>(mantissaOf(bits), 1);
+        int shift = 280 - 8 * static_cast<int>(exponentOf(bits));
+        if (shift <= 0) return 1;
+        if (shift >= 88) return UINT64_MAX;
+        unsigned __int128 work = (static_cast<unsigned __int128>(1) << shift) / mantissa;
+        return work > UINT64_MAX ? UINT64_MAX : std::max<uint64_t>(static_cast<uint64_t>(work), 1);
+    }
+    
+    // Cible multipliée par numerator / denominator (ajustement de difficulté)
+    static uint32_t scale(uint32_t bits, uint64_t numerator, uint64_t denominator) {
+        unsigned __int128 mantissa = static_cast<unsigned __int128>(mantissaOf(bits)) * numerator / denominator;
+        int exponent = static_cast<int>(exponentOf(bits));
+        while (mantissa > 0xffffff) {
+            mantissa >>= 8;
+            exponent++;
+        }
+        return encode(static_cast<uint64_t>(mantissa), exponent);
+    }
+    
+    static std::string toString(uint32_t bits) {
+        std::ostringstream out;
+        out << "0x" << std::hex << std::setw(8) << std::setfill('0') << bits;
+        return out.str();
+    }
+};
+
+static_assert(SHA256::equal(Target::expand(Target::fromZeroNibbles(3)),
+              SHA256::fromHex("0010000000000000000000000000000000000000000000000000000000000000")),
+              "Cible compacte incorrecte");
+
+// En-tête de bloc compact (85 octets sérialisés, à la manière de Bitcoin):
+// c'est lui seul qui est haché, les transactions n'y entrent que par le
+// Merkle Root. Un nœud léger peut donc suivre la chaîne avec les en-têtes seuls.
+struct BlockHeader {
+    static constexpr size_t SERIALIZED_SIZE = 85;
+    static constexpr uint32_t NO_VALIDATOR = 0xffffffff;
+    enum Consensus : uint8_t { NONE = 0, POW = 1, POS = 2 };
+    
+    uint32_t index = 0;
+    uint32_t timestamp = 0;                 // secondes Unix
+    SHA256::Digest previousHash = {};
+    SHA256::Digest merkleRoot = {};
+    uint32_t nonce = 0;
+    uint32_t validatorId = NO_VALIDATOR;    // PoS: indice du validateur
+    uint32_t bits = 0;                      // PoW: cible compacte (voir Target)
+    uint8_t consensus = NONE;
+    
+    // Encodage little-endian à largeur fixe (indépendant du padding mémoire)
+    constexpr std::array<uint8_t, SERIALIZED_SIZE> serialize() const {
+        std::array<uint8_t, SERIALIZED_SIZE> out = {};
+        size_t pos = 0;
+        auto put32 = [&out, &pos](uint32_t v) {
+            for (int i = 0; i < 4; i++) out[pos++] = static_cast<uint8_t>(v >> (8 * i));
+        };
+        put32(index);
+        put32(timestamp);
+        for (uint8_t b : previousHash) out[pos++] = b;
+        for (uint8_t b : merkleRoot) out[pos++] = b;
+        put32(nonce);
+        put32(validatorId);
+        put32(bits);
+        out[pos++] = consensus;
+        return out;
+    }
+    
+    // Inverse de serialize (lit SERIALIZED_SIZE octets)
+    static constexpr BlockHeader deserialize(const uint8_t* in) {
+        BlockHeader h;
+        size_t pos = 0;
+        auto get32 = [in, &pos]() {
+            uint32_t v = 0;
+            for (int i = 0; i < 4; i++) v |= uint32_t(in[pos++]) << (8 * i);
+            return v;
+        };
+        h.index = get32();
+        h.timestamp = get32();
+        for (uint8_t& b : h.previousHash) b = in[pos++];
+        for (uint8_t& b : h.merkleRoot) b = in[pos++];
+        h.nonce = get32();
+        h.validatorId = get32();
+        h.bits = get32();
+        h.consensus = in[pos++];
+        return h;
+    }
+    
+    constexpr SHA256::Digest computeHash() const {
+        auto bytes = serialize();
+        return SHA256::digest(bytes.data(), bytes.size());
+    }
+    
+    // La cible PoW se vérifie sur le hash déjà calculé
+    constexpr bool meetsDifficulty(const SHA256::Digest& hash) const {
+        return consensus != POW || Target::isMetBy(hash, Target::expand(bits));
+    }
+};
+
+// En-tête fixe du bloc genesis: son Merkle Root et son hash sont calculés à la
+// compilation, si bien que tous les processus partagent le même genesis et que
+// la construction d'une Blockchain ne coûte plus rien
+struct GenesisHeader {
+    static constexpr uint32_t TIMESTAMP = 1735689600;   // 1er janvier 2025, 00:00 UTC
+    static constexpr const char* VALIDATOR = "Genesis";
+    
+    // Transaction unique du genesis
+    static constexpr uint32_t TX_ID = 0;
+    static constexpr const char* TX_SENDER = "Genesis";
+    static constexpr const char* TX_RECEIVER = "System";
+    
+    static constexpr Transaction transaction() {
+        return Transaction(TX_ID, Address::fromName(TX_SENDER), Address::fromName(TX_RECEIVER), 0);
+    }
+    
+    // Avec une seule feuille, le Merkle Root est le hash de la transaction
+    static constexpr SHA256::Digest computeMerkleRoot() {
+        return transaction().getDigest();
+    }
+    
+    static constexpr BlockHeader header() {
+        BlockHeader h;
+        h.timestamp = TIMESTAMP;
+        h.merkleRoot = computeMerkleRoot();
+        h.consensus = BlockHeader::POS;
+        return h;
+    }
+};
+
+constexpr BlockHeader GENESIS_HEADER = GenesisHeader::header();
+constexpr SHA256::Digest GENESIS_HASH = GENESIS_HEADER.computeHash();
+static_assert(SHA256::equal(GENESIS_HASH,
+              SHA256::fromHex("871fb7c7849d06da402be6b11592f45fae2bcf693755dd8909ecedce6efaf75d")),
+              "Hash du bloc genesis inattendu");
+
+// Règles d'horodatage (inspirées de Bitcoin): un bloc ne peut pas être
+// antérieur à la médiane des 11 blocs précédents, ni trop loin dans le futur.
+// L'égalité est admise car plusieurs blocs peuvent être créés dans la même seconde.
+struct TimestampRules {
+    static constexpr size_t MEDIAN_WINDOW = 11;
+    static constexpr uint32_t MAX_FUTURE_DRIFT = 2 * 60 * 60;
+    
+    // `previous` contient les timestamps des blocs précédents, du plus ancien au plus récent
+    static uint32_t medianTimePast(const std::vector<uint32_t>& previous) {
+        size_t count = std::min(previous.size(), MEDIAN_WINDOW);
+        if (count == 0) return 0;
+        std::vector<uint32_t> window(previous.end() - count, previous.end());
+        std::sort(window.begin(), window.end());
+        return window[count / 2];
+    }
+    
+    static bool isAcceptable(uint32_t timestamp, uint32_t medianPast, uint32_t now) {
+        return timestamp >= medianPast && timestamp <= now + MAX_FUTURE_DRIFT;
+    }
+};
+
+// Réajustement automatique de la cible PoW vers un intervalle de blocs visé,
+// à partir des horodatages observés. Trois règles:
+//  - FIXED: cible constante (réglée à la main, comme avant);
+//  - WINDOW: tous les `window` blocs, cible × (durée observée / durée visée)
+//    sur la fenêtre écoulée, facteur borné à [1/4, 4] (à la Bitcoin);
+//  - EXPONENTIAL: à chaque bloc, moyenne mobile exponentielle du temps de
+//    bloc: cible × (N·T + t − T) / (N·T), t étant le dernier temps observé
+//    (borné à 6T) et N = `window` le lissage.
+// Les calculs sont entiers: tous les nœuds retrouvent la même cible.
+class DifficultyRetarget {
+public:
+    enum Rule : uint8_t { FIXED, WINDOW, EXPONENTIAL };
+    
+private:
+    Rule rule;
+    uint32_t spacing;      // intervalle visé entre deux blocs (s)
+    uint32_t window;       // taille de fenêtre (WINDOW) ou lissage (EXPONENTIAL)
+    uint32_t initialBits;  // cible du premier bloc PoW, et de toute la chaîne en FIXED
+    
+public:
+    explicit DifficultyRetarget(uint32_t bits = Target::fromZeroNibbles(3), Rule r = FIXED,
+                                uint32_t targetSpacing = 600, uint32_t windowSize = 20)
+        : rule(r), spacing(std::max(targetSpacing, 1u)), window(std::max(windowSize, 2u)),
+          initialBits(bits) {}
+    
+    // Cible exigée du bloc de hauteur `height`. ancestor(k) renvoie l'en-tête
+    // du bloc de hauteur height − 1 − k (nullptr au-delà du genesis). Seuls
+    // les blocs PoW comptent: derrière un bloc PoS ou le genesis, la cible
+    // initiale s'applique.
+    template <typename Ancestor>
+    uint32_t nextBits(uint32_t height, Ancestor ancestor) const {
+        if (rule == FIXED) return initialBits;
+        const BlockHeader* parent = ancestor(0);
+        if (parent == nullptr || parent->consensus != BlockHeader::POW) return initialBits;
+        
+        if (rule == EXPONENTIAL) {
+            const BlockHeader* grandparent = ancestor(1);
+            if (grandparent == nullptr || grandparent->consensus != BlockHeader::POW) return parent->bits;
+            int64_t solveTime = static_cast<int64_t>(parent->timestamp) - grandparent->timestamp;
+            solveTime = std::min<int64_t>(std::max<int64_t>(solveTime, 0), 6 * int64_t(spacing));
+            uint64_t smoothing = uint64_t(window) * spacing;
+            return Target::scale(parent->bits, smoothing + solveTime - spacing, smoothing);
+        }
+        
+        // WINDOW: la cible ne change qu'aux frontières de fenêtre
+        if (height % window != 0) return parent->bits;
+        const BlockHeader* first = ancestor(window);
+        for (uint32_t k = 1; k <= window && first != nullptr; k++) {
+            if (ancestor(k)->consensus != BlockHeader::POW) first = nullptr;
+        }
+        if (first == nullptr) return parent->bits;
+        
+        uint64_t expected = uint64_t(window) * spacing;
+        int64_t observed = static_cast<int64_t>(parent->timestamp) - first->timestamp;
+        uint64_t actual = static_cast<uint64_t>(std::min<int64_t>(
+            std::max<int64_t>(observed, static_cast<int64_t>(expected / 4)), static_cast<int64_t>(expected * 4)));
+        return Target::scale(parent->bits, actual, expected);
+    }
+    
+    Rule getRule() const { return rule; }
+    uint32_t getSpacing() const { return spacing; }
+    uint32_t getInitialBits() const { return initialBits; }
+    void setInitialBits(uint32_t bits) { initialBits = bits; }
+    
+    std::string describe() const {
+        if (rule == FIXED) return "cible fixe";
+        std::string name = (rule == WINDOW) ? "fenêtre de " : "moyenne exponentielle sur ";
+        return name + std::to_string(window) + " blocs";
+    }
+};
+
+// Arène mémoire: de grandes plaques allouées une fois, dans lesquelles les
+// objets sont posés les uns après les autres. Les adresses restent stables;
+// la libération se fait en bloc (destruction de l'arène) ou en pile, en
+// revenant à un repère (la chaîne ne se déconnecte que par la tête). Les
+// objets posés doivent être trivialement destructibles.
+class Arena {
+public:
+    struct Marker {
+        size_t slab;
+        size_t offset;
+    };
+    
+private:
+    static constexpr size_t SLAB_SIZE = 1 << 20;
+    
+    struct Slab {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+        size_t used;
+    };
+    
+    std::vector<Slab> slabs;
+    
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    
+    void* allocate(size_t bytes, size_t alignment) {
+        if (!slabs.empty()) {
+            Slab& slab = slabs.back();
+            size_t start = (slab.used + alignment - 1) / alignment * alignment;
+            if (start + bytes <= slab.size) {
+                slab.used = start + bytes;
+                return slab.data.get() + start;
+            }
+        }
+        // Les plaques sont alignées pour tout type fondamental
+        size_t size = std::max(SLAB_SIZE, bytes);
+        slabs.push_back(Slab{std::unique_ptr<uint8_t[]>(new uint8_t[size]), size, bytes});
+        return slabs.back().data.get();
+    }
+    
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena: type trivialement destructible requis");
+        if (count == 0) return nullptr;
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+    
+    Marker mark() const {
+        if (slabs.empty()) return Marker{0, 0};
+        return Marker{slabs.size() - 1, slabs.back().used};
+    }
+    
+    // Libère tout ce qui a été alloué depuis `marker`
+    void release(const Marker& marker) {
+        if (slabs.empty()) return;
+        slabs.resize(std::min(slabs.size(), marker.slab + 1));
+        slabs.back().used = std::min(slabs.back().used, marker.offset);
+    }
+    
+    size_t bytesUsed() const {
+        size_t total = 0;
+        for (const auto& slab : slabs) total += slab.used;
+        return total;
+    }
+    
+    size_t slabCount() const { return slabs.size(); }
+};
+
+// Un bloc, ses transactions et les bits de son filtre de Bloom sont posés
+// d'un seul tenant dans l'arène de la chaîne (Block::create): aucune
+// allocation individuelle, et un parcours de la chaîne lit des zones contiguës.
+class Block {
+public:
+    static constexpr size_t VALIDATOR_NAME_SIZE = 24;
+    
+private:
+    BlockHeader header;
+    SHA256::Digest hashDigest;
+    const Transaction* transactions;    // dans l'arène
+    const TransactionWitness* witnesses;   // tableau à part: lu seulement par la vérification des signatures
+    uint32_t transactionCount;
+    char validator[VALIDATOR_NAME_SIZE];   // nom du validateur (affichage uniquement, tronqué)
+    BloomFilter filter;                 // txids et adresses du bloc
+    
+    static std::string formatTimestamp(uint32_t ts) {
+        std::time_t t = static_cast<std::time_t>(ts);
+        std::string s = std::ctime(&t);
+        if (!s.empty() && s.back() == '\n') s.pop_back();
+        return s;
+    }
+    
+    void setHash(const SHA256::Digest& d) {
+        hashDigest = d;
+    }
+    
+    void setValidator(const std::string& name) {
+        size_t len = std::min(name.size(), VALIDATOR_NAME_SIZE - 1);
+        std::copy(name.begin(), name.begin() + len, validator);
+        validator[len] = '\0';
+    }
+    
+    Block() : header(), hashDigest(), transactions(nullptr), witnesses(nullptr), transactionCount(0), validator{}, filter() {}
+    
+    // Pose le bloc, ses transactions et son filtre dans l'arène
+    static Block* place(Arena& arena, TransactionSpan txs, double falsePositiveRate) {
+        Block* block = new (arena.allocateArray<Block>(1)) Block();
+        
+        Transaction* copies = arena.allocateArray<Transaction>(txs.size());
+        TransactionWitness* witnesses = arena.allocateArray<TransactionWitness>(txs.size());
+        for (size_t i = 0; i < txs.size(); i++) {
+            new (copies + i) Transaction(txs[i]);
+            new (witnesses + i) TransactionWitness(txs.witnessAt(i));
+        }
+        block->transactions = copies;
+        block->witnesses = witnesses;
+        block->transactionCount = static_cast<uint32_t>(txs.size());
+        
+        BloomFilter::Shape shape = BloomFilter::shapeFor(txs.size() * 3, falsePositiveRate);
+        block->filter = BloomFilter(arena.allocateArray<uint64_t>(shape.wordCount), shape);
+        for (const auto& tx : txs) {
+            block->filter.insert(tx.getDigest());
+            block->filter.insert(tx.getSender());
+            block->filter.insert(tx.getReceiver());
+        }
+        return block;
+    }
+    
+public:
+    static Block* create(Arena& arena, int idx, TransactionSpan txs, const SHA256::Digest& prevHash,
+                         double falsePositiveRate = BloomFilter::DEFAULT_FALSE_POSITIVE_RATE) {
+        return createWithMerkleRoot(arena, idx, txs, computeMerkleRoot(txs), prevHash, falsePositiveRate);
+    }
+    
+    // Variante pour un Merkle Root déjà calculé (étage dédié de l'import en masse)
+    static Block* createWithMerkleRoot(Arena& arena, int idx, TransactionSpan txs,
+                                       const SHA256::Digest& merkleRoot, const SHA256::Digest& prevHash,
+                                       double falsePositiveRate = BloomFilter::DEFAULT_FALSE_POSITIVE_RATE) {
+        Block* block = place(arena, txs, falsePositiveRate);
+        BlockHeader& header = block->header;
+        header.index = static_cast<uint32_t>(idx);
+        header.timestamp = static_cast<uint32_t>(std::time(nullptr));
+        header.previousHash = prevHash;
+        
+        header.merkleRoot = merkleRoot;
+        block->setHash(header.computeHash());
+        return block;
+    }
+    
+    // Bloc reçu d'un pair: l'en-tête est repris tel quel (déjà scellé) et
+    // seul son hash est recalculé; les vérifications sont celles de Blockchain
+    static Block* createFromHeader(Arena& arena, const BlockHeader& header, TransactionSpan txs,
+                                   double falsePositiveRate = BloomFilter::DEFAULT_FALSE_POSITIVE_RATE) {
+        Block* block = place(arena, txs, falsePositiveRate);
+        block->header = header;
+        block->setHash(header.computeHash());
+        return block;
+    }
+    
+    // Merkle Root binaire (tout à zéro pour un bloc sans transaction)
+    static SHA256::Digest computeMerkleRoot(TransactionSpan txs) {
+        MerkleTree merkleTree;
+        merkleTree.build(txs);
+        return merkleTree.getRootDigest();
+    }
+    
+    // Bloc genesis figé à la compilation: aucun calcul à la construction
+    static Block* createGenesis(Arena& arena) {
+        Address::remember(Address::fromName(GenesisHeader::TX_SENDER), GenesisHeader::TX_SENDER);
+        Address::remember(Address::fromName(GenesisHeader::TX_RECEIVER), GenesisHeader::TX_RECEIVER);
+        std::vector<Transaction> genesisTxs(1, GenesisHeader::transaction());
+        
+        Block* block = place(arena, genesisTxs, BloomFilter::DEFAULT_FALSE_POSITIVE_RATE);
+        block->header = GENESIS_HEADER;
+        block->setHash(GENESIS_HASH);
+        block->setValidator(GenesisHeader::VALIDATOR);
+        return block;
+    }
+    
+    // PROOF OF WORK
+    // Quand les 2^32 nonces sont épuisés, le timestamp avance d'une seconde
+    // et la recherche reprend sur un nouvel en-tête. attempts: hachages
+    // calculés au total.
+    long long mineBlock(uint32_t bits, uint64_t* attempts = nullptr) {
+        header.bits = bits;
+        header.consensus = BlockHeader::POW;
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        
+        // La boucle ne manipule que l'en-tête binaire: pas de formatage, et
+        // la cible n'est dépliée qu'une fois
+        const SHA256::Digest target = Target::expand(bits);
+        header.nonce = 0;
+        SHA256::Digest d = header.computeHash();
+        uint64_t tries = 1;
+        
+        while (!Target::isMetBy(d, target)) {
+            if (++header.nonce == 0) header.timestamp++;
+            d = header.computeHash();
+            tries++;
+        }
+        setHash(d);
+        if (attempts) *attempts = tries;
+        
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    }
+    
+    // PROOF OF STAKE
+    long long validateBlock(uint32_t validatorId, const std::string& val) {
+        header.consensus = BlockHeader::POS;
+        header.validatorId = validatorId;
+        setValidator(val);
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        
+        // Pas de puzzle en PoS: sceller revient à hacher l'en-tête. Les
+        // vérifications (signatures, soldes, Merkle Root, élection) sont
+        // faites et chronométrées par la Blockchain.
+        setHash(header.computeHash());
+        
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    }
+    
+    // Le hash stocké correspond-il au contenu de l'en-tête?
+    bool hasValidHash() const {
+        return SHA256::equal(hashDigest, header.computeHash());
+    }
+    
+    // Le Merkle Root stocké correspond-il aux transactions?
+    bool hasValidMerkleRoot() const {
+        return SHA256::equal(computeMerkleRoot(getTransactions()), header.merkleRoot);
+    }
+    
+    // Vérification peu coûteuse de la cible PoW (aucun hachage)
+    bool meetsDifficulty() const {
+        return header.meetsDifficulty(hashDigest);
+    }
+    
+    // Vérification de la validité du bloc
+    bool isValid() const {
+        return hasValidHash() && meetsDifficulty();
+    }
+    
+    // Affichage
+    void display() const {
+        std::string merkleRoot = SHA256::toHex(header.merkleRoot);
+        std::string previousHash = getPreviousHash();
+        
+        std::cout << "╔════════════════════════════════════════════════════════════╗" << std::endl;
+        std::cout << "║ BLOC #" << std::setw(51) << std::left << header.index << "║" << std::endl;
+        std::cout << "╠════════════════════════════════════════════════════════════╣" << std::endl;
+        std::cout << "║ Consensus: " << std::setw(47) << std::left << getConsensusType() << "║" << std::endl;
+        std::cout << "║ Timestamp: " << std::setw(47) << std::left << getTimestamp().substr(0, 47) << "║" << std::endl;
+        std::cout << "║ Transactions: " << std::setw(44) << std::left << transactionCount << "║" << std::endl;
+        
+        for (size_t i = 0; i < transactionCount && i < 3; i++) {
+            std::string txStr = transactions[i].getLabel() + ": " + 
+                               transactions[i].getSender().toString() + "→" + 
+                               transactions[i].getReceiver().toString();
+            std::cout << "║   • " << std::setw(53) << std::left << txStr.substr(0, 53) << "║" << std::endl;
+        }
+        
+        std::cout << "║ Merkle Root: " << std::setw(45) << std::left << merkleRoot.substr(0, 45) << "║" << std::endl;
+        
+        if (header.consensus == BlockHeader::POW) {
+            std::cout << "║ Nonce: " << std::setw(51) << std::left << header.nonce << "║" << std::endl;
+            std::string target = Target::toString(header.bits) + " (~" + std::to_string(Target::work(header.bits)) + " essais)";
+            std::cout << "║ Cible: " << std::setw(51) << std::left << target << "║" << std::endl;
+        } else if (header.consensus == BlockHeader::POS) {
+            std::cout << "║ Validateur: " << std::setw(46) << std::left << validator << "║" << std::endl;
+        }
+        
+        std::cout << "║ Hash précédent: " << std::setw(42) << std::left << previousHash.substr(0, 42) << "║" << std::endl;
+        std::cout << "║ Hash: " << std::setw(52) << std::left << getHash().substr(0, 52) << "║" << std::endl;
+        std::cout << "╚════════════════════════════════════════════════════════════╝" << std::endl;
+    }
+    
+    // Getters
+    int getIndex() const { return static_cast<int>(header.index); }
+    std::string getHash() const { return SHA256::toHex(hashDigest); }
+    std::string getPreviousHash() const { return SHA256::toHex(header.previousHash); }
+    std::string getTimestamp() const { return formatTimestamp(header.timestamp); }
+    std::string getConsensusType() const {
+        if (header.consensus == BlockHeader::POW) return "PoW";
+        if (header.consensus == BlockHeader::POS) return "PoS";
+        return "";
+    }
+    std::string getValidator() const { return std::string(validator); }
+    uint32_t getBits() const { return header.bits; }
+    const BlockHeader& getHeader() const { return header; }
+    const SHA256::Digest& getHashDigest() const { return hashDigest; }
+    TransactionSpan getTransactions() const { return TransactionSpan(transactions, witnesses, transactionCount); }
+    
+    // Tests sur le filtre seul: false = certainement absent, sans ouvrir le corps
+    bool mayInvolve(const Address& address) const { return filter.mightContain(address); }
+    bool mayContain(const SHA256::Digest& txid) const { return filter.mightContain(txid); }
+    const BloomFilter& getFilter() const { return filter; }
+};
+
+static_assert(std::is_trivially_destructible<Block>::value, "Block est libéré avec son arène");
+
+// ============================================================================
+// PARTIE 3.1: Pool de threads et validation parallèle de la chaîne
+// ============================================================================
+
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping;
+    
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                available.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+    
+public:
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency())
+        : stopping(false) {
+        if (threadCount == 0) threadCount = 1;
+        for (size_t i = 0; i < threadCount; i++) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+    
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        available.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    // Pool partagé par toute l'application
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+    
+    size_t size() const { return workers.size(); }
+    
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push(std::move(task));
+        }
+        available.notify_one();
+    }
+    
+    // Découpe [begin, end) en tranches de `chunk` éléments, appelle fn(lo, hi)
+    // sur chacune depuis le pool et attend la fin de toutes les tranches.
+    // Ne pas appeler depuis une tâche du pool (l'appelant bloque).
+    template <typename Fn>
+    void parallelFor(size_t begin, size_t end, size_t chunk, Fn fn) {
+        if (begin >= end) return;
+        if (chunk == 0) chunk = 1;
+        
+        size_t chunks = (end - begin + chunk - 1) / chunk;
+        std::mutex doneMutex;
+        std::condition_variable done;
+        size_t remaining = chunks;
+        
+        for (size_t c = 0; c < chunks; c++) {
+            size_t lo = begin + c * chunk;
+            size_t hi = std::min(end, lo + chunk);
+            submit([&, lo, hi] {
+                fn(lo, hi);
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (--remaining == 0) done.notify_one();
+            });
+        }
+        
+        std::unique_lock<std::mutex> lock(doneMutex);
+        done.wait(lock, [&] { return remaining == 0; });
+    }
+};
+
+// Vérification des signatures d'un bloc: les dépenses sont regroupées en
+// lots vérifiés chacun par une seule équation (Ed25519::verifyBatch), les
+// lots étant répartis sur le pool. Un lot en échec est revérifié signature
+// par signature pour désigner la première transaction fautive.
+class SignatureBatchVerifier {
+private:
+    ThreadPool* pool;       // nullptr = dans le thread appelant (déjà dans le pool)
+    size_t batchSize;
+    
+public:
+    explicit SignatureBatchVerifier(ThreadPool* p = &ThreadPool::shared(), size_t batch = 64)
+        : pool(p), batchSize(batch == 0 ? 1 : batch) {}
+    
+    // Indice de la première transaction mal signée, ou -1
+    long firstInvalid(TransactionSpan txs) const {
+        std::vector<size_t> spends;
+        for (size_t i = 0; i < txs.size(); i++) {
+            if (txs[i].isCoinbase()) continue;
+            if (!txs.witnessAt(i).matches(txs[i])) return static_cast<long>(i);
+            spends.push_back(i);
+        }
+        if (spends.empty()) return -1;
+        
+        size_t batches = (spends.size() + batchSize - 1) / batchSize;
+        std::vector<long> batchFailures(batches, -1);
+        uint64_t seed = (static_cast<uint64_t>(std::random_device()()) << 32) ^ std::random_device()();
+        
+        auto verifyRange = [&](size_t lo, size_t hi) {
+            for (size_t b = lo; b < hi; b++) {
+                size_t first = b * batchSize;
+                size_t last = std::min(spends.size(), first + batchSize);
+                
+                std::vector<Ed25519::BatchItem> items;
+                items.reserve(last - first);
+                for (size_t k = first; k < last; k++) {
+                    items.push_back(txs.witnessAt(spends[k]).itemFor(txs[spends[k]]));
+                }
+                if (Ed25519::verifyBatch(items.data(), items.size(), seed + b)) continue;
+                
+                for (size_t k = first; k < last; k++) {
+                    const Ed25519::BatchItem& item = items[k - first];
+                    if (!Ed25519::verify(item.publicKey, item.message, item.length, item.signature)) {
+                        batchFailures[b] = static_cast<long>(spends[k]);
+                        break;
+                    }
+                }
+            }
+        };
+        
+        if (pool) pool->parallelFor(0, batches, 1, verifyRange);
+        else verifyRange(0, batches);
+        
+        for (long failure : batchFailures) {
+            if (failure >= 0) return failure;
+        }
+        return -1;
+    }
+    
+    bool verifyAll(TransactionSpan txs) const { return firstInvalid(txs) < 0; }
+};
+
+// Résultat d'une validation: la plus petite hauteur invalide est toujours
+// celle rapportée, quel que soit l'ordonnancement des threads
+struct ValidationReport {
+    bool valid;
+    int firstInvalidHeight;   // -1 si la chaîne est valide
+    std::string reason;
+};
+
+// Recalcule les hash de blocs et les Merkle Roots et vérifie les signatures
+// en parallèle (travail coûteux et indépendant par bloc), puis vérifie les
+// liens et la difficulté dans une passe ordonnée peu coûteuse
+class ParallelChainValidator {
+private:
+    ThreadPool& pool;
+    size_t chunkSize;
+    
+public:
+    explicit ParallelChainValidator(ThreadPool& p = ThreadPool::shared(), size_t chunk = 256)
+        : pool(p), chunkSize(chunk) {}
+    
+    // Indique si l'en-tête PoS désigne bien le validateur élu pour son créneau
+    using LeaderCheck = std::function<bool(const BlockHeader&)>;
+    
+    ValidationReport validate(const std::vector<Block*>& chain, size_t from = 1,
+                              const LeaderCheck& isElectedLeader = nullptr) const {
+        if (from == 0) from = 1;
+        if (from >= chain.size()) return {true, -1, ""};
+        
+        // 1 = hash invalide, 2 = Merkle Root invalide, 3 = signature invalide,
+        // 4 = validateur non élu
+        std::vector<uint8_t> failures(chain.size(), 0);
+        std::atomic<size_t> lowestFailure(chain.size());
+        SignatureBatchVerifier signatures(nullptr);   // déjà réparti par bloc
+        
+        pool.parallelFor(from, chain.size(), chunkSize, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; i++) {
+                // Inutile de continuer au-delà d'un échec déjà trouvé plus bas
+                if (i > lowestFailure.load(std::memory_order_relaxed)) return;
+                
+                const Block* block = chain[i];
+                if (!block->hasValidHash()) failures[i] = 1;
+                else if (!block->hasValidMerkleRoot()) failures[i] = 2;
+                else if (!signatures.verifyAll(block->getTransactions())) failures[i] = 3;
+                else if (isElectedLeader && block->getHeader().consensus == BlockHeader::POS &&
+                         !isElectedLeader(block->getHeader())) failures[i] = 4;
+                
+                if (failures[i] != 0) {
+                    size_t current = lowestFailure.load();
+                    while (i < current && !lowestFailure.compare_exchange_weak(current, i)) {}
+                    return;
+                }
+            }
+        });
+        
+        // Passe ordonnée: liens, index, horodatage et difficulté
+        uint32_t now = static_cast<uint32_t>(std::time(nullptr));
+        std::vector<uint32_t> recentTimestamps;
+        for (size_t i = (from > TimestampRules::MEDIAN_WINDOW ? from - TimestampRules::MEDIAN_WINDOW : 0);
+             i < from; i++) {
+            recentTimestamps.push_back(chain[i]->getHeader().timestamp);
+        }
+        
+        for (size_t i = from; i < chain.size(); i++) {
+            const BlockHeader& header = chain[i]->getHeader();
+            int height = static_cast<int>(i);
+            
+            if (failures[i] == 1) return {false, height, "hash invalide"};
+            if (failures[i] == 2) return {false, height, "Merkle Root invalide"};
+            if (failures[i] == 3) return {false, height, "signature invalide"};
+            if (failures[i] == 4) return {false, height, "validateur non élu"};
+            if (header.index != i) return {false, height, "index incohérent"};
+            if (!SHA256::equal(header.previousHash, chain[i - 1]->getHashDigest())) {
+                return {false, height, "chaîne brisée"};
+            }
+            if (!TimestampRules::isAcceptable(header.timestamp,
+                    TimestampRules::medianTimePast(recentTimestamps), now)) {
+                return {false, height, "horodatage invalide"};
+            }
+            if (!chain[i]->meetsDifficulty()) return {false, height, "difficulté non atteinte"};
+            
+            recentTimestamps.push_back(header.timestamp);
+            if (recentTimestamps.size() > TimestampRules::MEDIAN_WINDOW) {
+                recentTimestamps.erase(recentTimestamps.begin());
+            }
+        }
+        
+        return {true, -1, ""};
+    }
+};
+
+// ============================================================================
+// PARTIE 3.2: Chaîne d'en-têtes pour nœuds légers
+// ============================================================================
+
+// Ne conserve que les en-têtes (~88 octets par bloc en mémoire): la preuve de
+// travail, les liens et les horodatages se vérifient sans les transactions,
+// dont les corps sont récupérés à la demande et contrôlés par leur Merkle Root
+class HeaderChain {
+public:
+    using BodySource = std::function<std::vector<Transaction>(uint32_t height)>;
+    
+private:
+    std::vector<BlockHeader> headers;
+    std::vector<uint32_t> recentTimestamps;   // fenêtre de la médiane
+    SHA256::Digest tipHash;
+    BodySource bodySource;
+    DifficultyRetarget retarget;
+    
+public:
+    HeaderChain() : tipHash(GENESIS_HASH) {
+        headers.push_back(GENESIS_HEADER);
+        recentTimestamps.push_back(GENESIS_HEADER.timestamp);
+    }
+    
+    // Vérifie un en-tête par rapport à la pointe puis l'ajoute
+    bool addHeader(const BlockHeader& header, std::string* reason = nullptr) {
+        auto reject = [reason](const char* why) {
+            if (reason) *reason = why;
+            return false;
+        };
+        
+        SHA256::Digest hash = header.computeHash();
+        uint32_t now = static_cast<uint32_t>(std::time(nullptr));
+        
+        if (header.index != headers.size()) return reject("index incohérent");
+        if (!SHA256::equal(header.previousHash, tipHash)) return reject("chaîne brisée");
+        if (!TimestampRules::isAcceptable(header.timestamp,
+                TimestampRules::medianTimePast(recentTimestamps), now)) {
+            return reject("horodatage invalide");
+        }
+        if (!header.meetsDifficulty(hash)) return reject("difficulté non atteinte");
+        // Cible toujours contrôlée, cible fixe comprise: sinon le travail d'une
+        // branche serait celui que son auteur a déclaré
+        if (header.consensus == BlockHeader::POW &&
+            header.bits != retarget.nextBits(header.index, [this](uint32_t k) -> const BlockHeader* {
+                return k < headers.size() ? &headers[headers.size() - 1 - k] : nullptr;
+            })) {
+            return reject("cible inattendue");
+        }
+        
+        headers.push_back(header);
+        tipHash = hash;
+        recentTimestamps.push_back(header.timestamp);
+        if (recentTimestamps.size() > TimestampRules::MEDIAN_WINDOW) {
+            recentTimestamps.erase(recentTimestamps.begin());
+        }
+        return true;
+    }
+    
+    void setBodySource(BodySource source) { bodySource = std::move(source); }
+    
+    // Règle de la chaîne suivie, à fixer avant d'ajouter des en-têtes
+    void setRetarget(const DifficultyRetarget& rule) { retarget = rule; }
+    
+    // Récupère le corps d'un bloc et vérifie qu'il correspond à l'en-tête
+    bool fetchBody(uint32_t height, std::vector<Transaction>& out) const {
+        if (!bodySource || height >= headers.size()) return false;
+        std::vector<Transaction> body = bodySource(height);
+        if (!SHA256::equal(Block::computeMerkleRoot(body), headers[height].merkleRoot)) {
+            return false;
+        }
+        out = std::move(body);
+        return true;
+    }
+    
+    const BlockHeader& getHeader(uint32_t height) const { return headers[height]; }
+    const SHA256::Digest& getTipHash() const { return tipHash; }
+    size_t size() const { return headers.size(); }
+    size_t memoryUsage() const { return headers.capacity() * sizeof(BlockHeader); }
+};
+
+// ============================================================================
+// PARTIE 3.3: Registre de comptes et exécution parallèle optimiste
+// ============================================================================
+
+// Soldes par compte (en centièmes), avec la même sémantique que l'ensemble
+// UTXO: une transaction sans input crédite le destinataire (émission), les
+// autres débitent l'émetteur du montant et des frais et échouent sans effet
+// si son solde est insuffisant
+class AccountLedger {
+public:
+    // Anciens soldes des comptes modifiés par un bloc, pour l'annuler
+    using BlockUndo = std::vector<std::pair<Address, Amount>>;
+    
+private:
+    std::unordered_map<Address, Amount, Address::Hash> balances;
+    
+public:
+    // Exécute une transaction sur des soldes lus; false si elle échoue
+    // (montant ou frais négatif, fonds insuffisants, solde hors de int64)
+    static bool execute(const Transaction& tx, Amount senderBalance, Amount receiverBalance,
+                        Amount& newSenderBalance, Amount& newReceiverBalance) {
+        Amount amount = tx.getAmount();
+        Amount fee = tx.getFee();
+        newSenderBalance = senderBalance;
+        newReceiverBalance = receiverBalance;
+        if (!tx.hasValidAmounts()) return false;
+        if (amount > std::numeric_limits<Amount>::max() - receiverBalance) return false;
+        newReceiverBalance = receiverBalance + amount;
+        if (tx.isCoinbase()) return true;
+        
+        // Comparaisons sans somme amount + fee: pas de dépassement
+        if (fee > senderBalance || amount > senderBalance - fee) return false;
+        Amount debit = amount + fee;
+        newSenderBalance = senderBalance - debit;
+        if (tx.getSender() == tx.getReceiver()) {
+            newReceiverBalance = newSenderBalance + amount;
+            newSenderBalance = newReceiverBalance;
+        }
+        return true;
+    }
+    
+    Amount balanceOf(const Address& address) const {
+        auto it = balances.find(address);
+        return (it == balances.end()) ? 0 : it->second;
+    }
+    
+    void setBalance(const Address& address, Amount value) {
+        balances[address] = value;
+    }
+    
+    // Exécution de référence, strictement dans l'ordre
+    std::vector<uint8_t> applySequential(TransactionSpan txs) {
+        std::vector<uint8_t> succeeded(txs.size(), 0);
+        for (size_t i = 0; i < txs.size(); i++) {
+            const Transaction& tx = txs[i];
+            Amount sender = 0, receiver = 0;
+            if (execute(tx, balanceOf(tx.getSender()), balanceOf(tx.getReceiver()), sender, receiver)) {
+                if (!tx.isCoinbase()) balances[tx.getSender()] = sender;
+                balances[tx.getReceiver()] = receiver;
+                succeeded[i] = 1;
+            }
+        }
+        return succeeded;
+    }
+    
+    void revert(const BlockUndo& undo) {
+        for (auto it = undo.rbegin(); it != undo.rend(); ++it) {
+            if (it->second == 0) balances.erase(it->first);
+            else balances[it->first] = it->second;
+        }
+    }
+    
+    size_t accountCount() const { return balances.size(); }
+};
+
+// Exécution optimiste d'un bloc dans l'esprit de Block-STM: toutes les
+// transactions s'exécutent en parallèle sur une mémoire multi-versions (une
+// liste de versions par compte), en notant la version de chaque lecture.
+// Une phase de validation, parallèle elle aussi, invalide les transactions
+// dont une lecture ne correspond plus à la dernière écriture d'une
+// transaction antérieure; seules celles-ci sont réexécutées. La plus petite
+// transaction invalide devient valide au tour suivant, d'où un résultat
+// identique à l'exécution séquentielle en au plus n tours (deux quand les
+// comptes touchés sont disjoints).
+class ParallelLedgerExecutor {
+public:
+    struct Result {
+        std::vector<uint8_t> succeeded;
+        AccountLedger::BlockUndo undo;
+        size_t rounds;
+        size_t reexecutions;
+    };
+    
+private:
+    static constexpr int32_t BASE_VERSION = -1;   // lecture dans l'état de départ
+    
+    struct Version {
+        int32_t txIndex;
+        uint32_t incarnation;
+        bool operator==(const Version& o) const { return txIndex == o.txIndex && incarnation == o.incarnation; }
+    };
+    
+    struct VersionedValue {
+        int32_t txIndex;
+        uint32_t incarnation;
+        Amount value;
+    };
+    
+    // Mémoire multi-versions d'un compte, triée par indice de transaction
+    struct AccountCell {
+        std::mutex mutex;
+        Amount base = 0;
+        std::vector<VersionedValue> versions;
+    };
+    
+    struct Access {
+        uint32_t account;
+        Version version;
+    };
+    
+    struct TxState {
+        uint32_t incarnation = 0;
+        std::vector<Access> reads;
+        std::vector<uint32_t> writes;
+        bool success = false;
+    };
+    
+    ThreadPool& pool;
+    size_t chunkSize;
+    
+    // Dernière écriture d'une transaction d'indice < txIndex
+    static Amount readBefore(AccountCell& cell, int32_t txIndex, Version& version) {
+        std::lock_guard<std::mutex> lock(cell.mutex);
+        for (auto it = cell.versions.rbegin(); it != cell.versions.rend(); ++it) {
+            if (it->txIndex < txIndex) {
+                version = {it->txIndex, it->incarnation};
+                return it->value;
+            }
+        }
+        version = {BASE_VERSION, 0};
+        return cell.base;
+    }
+    
+    static void removeVersion(AccountCell& cell, int32_t txIndex) {
+        std::lock_guard<std::mutex> lock(cell.mutex);
+        for (auto it = cell.versions.begin(); it != cell.versions.end(); ++it) {
+            if (it->txIndex == txIndex) {
+                cell.versions.erase(it);
+                return;
+            }
+        }
+    }
+    
+    static void writeVersion(AccountCell& cell, int32_t txIndex, uint32_t incarnation, Amount value) {
+        std::lock_guard<std::mutex> lock(cell.mutex);
+        auto it = cell.versions.begin();
+        while (it != cell.versions.end() && it->txIndex < txIndex) ++it;
+        if (it != cell.versions.end() && it->txIndex == txIndex) {
+            *it = {txIndex, incarnation, value};
+        } else {
+            cell.versions.insert(it, {txIndex, incarnation, value});
+        }
+    }
+    
+public:
+    explicit ParallelLedgerExecutor(ThreadPool& p = ThreadPool::shared(), size_t chunk = 512)
+        : pool(p), chunkSize(chunk) {}
+    
+    Result execute(AccountLedger& ledger, TransactionSpan txs) {
+        Result result{std::vector<uint8_t>(txs.size(), 0), {}, 0, 0};
+        if (txs.empty()) return result;
+        
+        // Identifiants denses des comptes touchés par le bloc
+        std::unordered_map<Address, uint32_t, Address::Hash> accountIds;
+        std::vector<Address> accounts;
+        std::vector<std::pair<uint32_t, uint32_t>> touched(txs.size());
+        auto intern = [&](const Address& address) {
+            auto it = accountIds.emplace(address, static_cast<uint32_t>(accounts.size()));
+            if (it.second) accounts.push_back(address);
+            return it.first->second;
+        };
+        for (size_t i = 0; i < txs.size(); i++) {
+            touched[i] = {intern(txs[i].getSender()), intern(txs[i].getReceiver())};
+        }
+        
+        std::unique_ptr<AccountCell[]> cells(new AccountCell[accounts.size()]);
+        for (size_t a = 0; a < accounts.size(); a++) {
+            cells[a].base = ledger.balanceOf(accounts[a]);
+        }
+        
+        std::vector<TxState> states(txs.size());
+        
+        auto runIncarnation = [&](size_t i) {
+            const Transaction& tx = txs[i];
+            TxState& state = states[i];
+            int32_t index = static_cast<int32_t>(i);
+            uint32_t senderId = touched[i].first;
+            uint32_t receiverId = touched[i].second;
+            
+            state.reads.clear();
+            Version receiverVersion{BASE_VERSION, 0};
+            Version senderVersion{BASE_VERSION, 0};
+            Amount receiverBalance = readBefore(cells[receiverId], index, receiverVersion);
+            Amount senderBalance = receiverBalance;
+            state.reads.push_back({receiverId, receiverVersion});
+            if (!tx.isCoinbase() && senderId != receiverId) {
+                senderBalance = readBefore(cells[senderId], index, senderVersion);
+                state.reads.push_back({senderId, senderVersion});
+            }
+            
+            Amount newSender = 0, newReceiver = 0;
+            state.success = AccountLedger::execute(tx, senderBalance, receiverBalance, newSender, newReceiver);
+            
+            // Les écritures de l'incarnation précédente sont remplacées
+            std::vector<uint32_t> previousWrites;
+            previousWrites.swap(state.writes);
+            if (state.success) {
+                writeVersion(cells[receiverId], index, state.incarnation, newReceiver);
+                state.writes.push_back(receiverId);
+                if (!tx.isCoinbase() && senderId != receiverId) {
+                    writeVersion(cells[senderId], index, state.incarnation, newSender);
+                    state.writes.push_back(senderId);
+                }
+            }
+            for (uint32_t account : previousWrites) {
+                if (std::find(state.writes.begin(), state.writes.end(), account) == state.writes.end()) {
+                    removeVersion(cells[account], index);
+                }
+            }
+        };
+        
+        std::vector<size_t> pending(txs.size());
+        for (size_t i = 0; i < txs.size(); i++) pending[i] = i;
+        
+        while (!pending.empty()) {
+            result.rounds++;
+            if (result.rounds > 1) result.reexecutions += pending.size();
+            
+            // Exécution spéculative
+            pool.parallelFor(0, pending.size(), chunkSize, [&](size_t lo, size_t hi) {
+                for (size_t k = lo; k < hi; k++) runIncarnation(pending[k]);
+            });
+            
+            // Validation: les transactions sous la plus petite réexécutée sont stables
+            size_t firstPending = pending.front();
+            std::vector<uint8_t> invalid(txs.size(), 0);
+            pool.parallelFor(firstPending, txs.size(), chunkSize, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; i++) {
+                    for (const Access& read : states[i].reads) {
+                        Version current{BASE_VERSION, 0};
+                        readBefore(cells[read.account], static_cast<int32_t>(i), current);
+                        if (!(current == read.version)) {
+                            invalid[i] = 1;
+                            break;
+                        }
+                    }
+                }
+            });
+            
+            pending.clear();
+            for (size_t i = firstPending; i < txs.size(); i++) {
+                if (invalid[i]) {
+                    states[i].incarnation++;
+                    pending.push_back(i);
+                }
+            }
+        }
+        
+        // Publication: dernière version de chaque compte modifié
+        for (size_t a = 0; a < accounts.size(); a++) {
+            if (cells[a].versions.empty()) continue;
+            result.undo.push_back({accounts[a], cells[a].base});
+            ledger.setBalance(accounts[a], cells[a].versions.back().value);
+        }
+        for (size_t i = 0; i < txs.size(); i++) {
+            result.succeeded[i] = states[i].success ? 1 : 0;
+        }
+        return result;
+    }
+};
+
+// ============================================================================
+// PARTIE 3.4: Index inversé adresse → transactions
+// ============================================================================
+
+// Pour chaque adresse, la liste de ses occurrences (hauteur, position dans le
+// bloc), maintenue bloc par bloc. Les listes sont triées par hauteur par
+// construction: déconnecter le bloc de tête revient à retirer leurs queues.
+class AddressIndex {
+public:
+    struct Posting {
+        uint32_t height;
+        uint32_t position;
+    };
+    
+private:
+    std::unordered_map<Address, std::vector<Posting>, Address::Hash> postings;
+    size_t postingCount;
+    
+public:
+    AddressIndex() : postingCount(0) {}
+    
+    void connectBlock(TransactionSpan txs, uint32_t height) {
+        for (size_t i = 0; i < txs.size(); i++) {
+            Posting posting{height, static_cast<uint32_t>(i)};
+            postings[txs[i].getSender()].push_back(posting);
+            if (txs[i].getReceiver() != txs[i].getSender()) {
+                postings[txs[i].getReceiver()].push_back(posting);
+            }
+            postingCount += (txs[i].getReceiver() != txs[i].getSender()) ? 2 : 1;
+        }
+    }
+    
+    void disconnectBlock(TransactionSpan txs, uint32_t height) {
+        for (const auto& tx : txs) {
+            for (const Address* address : {&tx.getSender(), &tx.getReceiver()}) {
+                auto it = postings.find(*address);
+                if (it == postings.end()) continue;
+                while (!it->second.empty() && it->second.back().height == height) {
+                    it->second.pop_back();
+                    postingCount--;
+                }
+                if (it->second.empty()) postings.erase(it);
+            }
+        }
+    }
+    
+    const std::vector<Posting>& lookup(const Address& address) const {
+        static const std::vector<Posting> none;
+        auto it = postings.find(address);
+        return (it == postings.end()) ? none : it->second;
+    }
+    
+    size_t addressCount() const { return postings.size(); }
+    size_t size() const { return postingCount; }
+};
+
+// ============================================================================
+// PARTIE 3.5: Arbre de blocs et choix de la branche (fork choice)
+// ============================================================================
+
+// Tous les blocs reçus, branches concurrentes comprises, indexés par hash.
+// Chaque nœud porte son poids propre (travail attendu en PoW, stake du
+// producteur et des attestations en PoS) et son score, le poids cumulé depuis
+// le genesis. La meilleure pointe est tenue à jour à chaque insertion: changer
+// de tête coûte O(1), seule la réorganisation de l'état parcourt un suffixe.
+class BlockTree {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId NONE = 0xffffffff;
+    
+    struct Node {
+        Block* block;
+        NodeId parent;
+        NodeId firstChild;
+        NodeId nextSibling;
+        uint32_t height;
+        uint64_t weight;    // poids propre du bloc
+        uint64_t score;     // poids cumulé du genesis à ce bloc inclus
+        bool invalid;       // refusé à la connexion (lui ou un ancêtre)
+    };
+    
+private:
+    std::vector<Node> nodes;
+    std::unordered_map<SHA256::Digest, NodeId, DigestHash> byHash;
+    NodeId best;
+    
+    // Un candidat doit être strictement plus lourd que la tête: à égalité, le
+    // premier reçu garde l'avantage, sauf s'il s'agit d'un enfant de la tête
+    // (un bloc PoS de poids nul prolonge quand même la chaîne)
+    bool beats(NodeId candidate) const {
+        if (best == NONE) return true;
+        if (nodes[candidate].score != nodes[best].score) return nodes[candidate].score > nodes[best].score;
+        return nodes[candidate].parent == best;
+    }
+    
+    template <typename Visit>
+    void forEachInSubtree(NodeId root, Visit visit) {
+        std::vector<NodeId> pending(1, root);
+        while (!pending.empty()) {
+            NodeId id = pending.back();
+            pending.pop_back();
+            visit(id);
+            for (NodeId child = nodes[id].firstChild; child != NONE; child = nodes[child].nextSibling) {
+                pending.push_back(child);
+            }
+        }
+    }
+    
+public:
+    BlockTree() : best(NONE) {}
+    
+    NodeId insert(Block* block, NodeId parent, uint64_t weight) {
+        NodeId id = static_cast<NodeId>(nodes.size());
+        Node node;
+        node.block = block;
+        node.parent = parent;
+        node.firstChild = NONE;
+        node.nextSibling = NONE;
+        node.height = (parent == NONE) ? 0 : nodes[parent].height + 1;
+        node.weight = weight;
+        node.score = ((parent == NONE) ? 0 : nodes[parent].score) + weight;
+        node.invalid = parent != NONE && nodes[parent].invalid;
+        if (parent != NONE) {
+            node.nextSibling = nodes[parent].firstChild;
+            nodes[parent].firstChild = id;
+        }
+        nodes.push_back(node);
+        byHash.emplace(block->getHashDigest(), id);
+        
+        if (!node.invalid && beats(id)) best = id;
+        return id;
+    }
+    
+    NodeId find(const SHA256::Digest& hash) const {
+        auto it = byHash.find(hash);
+        return it == byHash.end() ? NONE : it->second;
+    }
+    
+    // Attestation: le poids d'un bloc augmente, et avec lui le score de tous
+    // ses descendants (seule cette sous-arborescence est parcourue)
+    void addWeight(NodeId id, uint64_t delta) {
+        nodes[id].weight += delta;
+        forEachInSubtree(id, [&](NodeId n) {
+            nodes[n].score += delta;
+            if (!nodes[n].invalid && beats(n)) best = n;
+        });
+    }
+    
+    // Bloc refusé à la connexion: lui et ses descendants sont écartés. Si la
+    // tête en faisait partie, la meilleure pointe valide est recherchée
+    // parmi tous les nœuds (cas rare).
+    void markInvalid(NodeId id) {
+        forEachInSubtree(id, [&](NodeId n) { nodes[n].invalid = true; });
+        if (best != NONE && nodes[best].invalid) {
+            best = NONE;
+            for (NodeId n = 0; n < nodes.size(); n++) {
+                if (!nodes[n].invalid && beats(n)) best = n;
+            }
+        }
+    }
+    
+    // Dernier ancêtre commun (point de bifurcation) de deux nœuds
+    NodeId commonAncestor(NodeId a, NodeId b) const {
+        while (nodes[a].height > nodes[b].height) a = nodes[a].parent;
+        while (nodes[b].height > nodes[a].height) b = nodes[b].parent;
+        while (a != b) {
+            a = nodes[a].parent;
+            b = nodes[b].parent;
+        }
+        return a;
+    }
+    
+    const Node& get(NodeId id) const { return nodes[id]; }
+    NodeId getBest() const { return best; }
+    size_t size() const { return nodes.size(); }
+    
+    size_t tipCount() const {
+        size_t tips = 0;
+        for (const Node& node : nodes) tips += (node.firstChild == NONE) ? 1 : 0;
+        return tips;
+    }
+};
+
+// ============================================================================
+// PARTIE 4: Classe Blockchain
+// ============================================================================
+
+// Temps passé dans chaque étape de l'ajout d'un bloc, en µs: ce sont ces
+// étapes (et non une attente simulée) qui bornent le débit d'une chaîne PoS
+struct BlockTiming {
+    using Clock = std::chrono::high_resolution_clock;
+    
+    long long signatures = 0;    // signatures Ed25519, vérifiées par lots
+    long long utxo = 0;          // sorties inconnues et double dépense
+    long long balances = 0;      // soldes des comptes (exécution parallèle)
+    long long index = 0;         // index adresse → transactions
+    long long merkle = 0;        // Merkle Root recalculé depuis les transactions
+    long long eligibility = 0;   // PoS: le validateur est-il l'élu du créneau?
+    long long seal = 0;          // PoW: minage; PoS: hash de l'en-tête
+    uint64_t attempts = 0;       // hachages calculés pour sceller le bloc
+    
+    static long long since(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    }
+    
+    long long total() const {
+        return signatures + utxo + balances + index + merkle + eligibility + seal;
+    }
+    
+    BlockTiming& operator+=(const BlockTiming& other) {
+        signatures += other.signatures;
+        utxo += other.utxo;
+        balances += other.balances;
+        index += other.index;
+        merkle += other.merkle;
+        eligibility += other.eligibility;
+        seal += other.seal;
+        attempts += other.attempts;
+        return *this;
+    }
+    
+    void display() const {
+        std::cout << "   ⏱️  signatures " << signatures << " µs | UTXO " << utxo
+                  << " µs | soldes " << balances << " µs | index " << index
+                  << " µs | Merkle " << merkle << " µs | éligibilité " << eligibility
+                  << " µs | scellement " << seal << " µs" << std::endl;
+    }
+};
+
+class Blockchain {
+private:
+    Arena arena;                        // blocs et transactions, libérés d'un coup
+    std::vector<Block*> chain;          // branche active, du genesis à la tête
+    BlockTree tree;                     // tous les blocs reçus, branches concurrentes comprises
+    std::vector<BlockTree::NodeId> activeNodes;   // nœud de l'arbre de chaque bloc de chain
+    std::unordered_set<uint64_t> attestations;    // (nœud, validateur) déjà comptés
+    ValidatorRegistry validators;             // stakes appliqués (figés à chaque époque)
+    EpochScheduler epochs;
+    std::vector<std::pair<ValidatorRegistry::Id, uint64_t>> pendingStakes;   // appliqués à la prochaine époque
+    std::map<uint32_t, std::shared_ptr<const StakeSampler>> frozenStakes;     // figés à l'entrée de chaque époque
+    BlockTiming lastBlockTiming;
+    DifficultyRetarget retarget;        // cible exigée de chaque bloc PoW
+    Mempool mempool;
+    UtxoSet utxos;
+    std::vector<UtxoSet::BlockUndo> undoLog;   // un journal par bloc de la chaîne
+    AccountLedger ledger;
+    std::vector<AccountLedger::BlockUndo> ledgerUndoLog;
+    AddressIndex addressIndex;
+    double bloomFalsePositiveRate;
+    
+    // Réorganisations effectuées (changements de branche qui défont des blocs)
+    size_t reorgCount;
+    size_t reorgDisconnected;
+    size_t reorgConnected;
+    long long lastReorgMicros;
+    
+    // Vérifie les signatures (par lots, en parallèle), puis applique les
+    // transactions d'un futur bloc à l'ensemble UTXO et aux soldes des
+    // comptes (exécution parallèle optimiste)
+    bool connectTransactions(TransactionSpan transactions, int index, BlockTiming* timing = nullptr) {
+        BlockTiming local;
+        BlockTiming& t = timing ? *timing : local;
+        
+        auto stage = BlockTiming::Clock::now();
+        long forged = SignatureBatchVerifier().firstInvalid(transactions);
+        t.signatures = BlockTiming::since(stage);
+        if (forged >= 0) {
+            std::cout << "❌ Bloc #" << index << " rejeté: "
+                      << transactions[forged].getLabel() << ": signature invalide" << std::endl;
+            return false;
+        }
+        
+        stage = BlockTiming::Clock::now();
+        UtxoSet::BlockUndo undo;
+        std::string reason;
+        bool spendable = utxos.connectBlock(transactions, static_cast<uint32_t>(index), undo, &reason);
+        t.utxo = BlockTiming::since(stage);
+        if (!spendable) {
+            std::cout << "❌ Bloc #" << index << " rejeté: " << reason << std::endl;
+            return false;
+        }
+        undoLog.push_back(std::move(undo));
+        
+        stage = BlockTiming::Clock::now();
+        ParallelLedgerExecutor executor;
+        ledgerUndoLog.push_back(executor.execute(ledger, transactions).undo);
+        t.balances = BlockTiming::since(stage);
+        
+        stage = BlockTiming::Clock::now();
+        addressIndex.connectBlock(transactions, static_cast<uint32_t>(index));
+        t.index = BlockTiming::since(stage);
+        return true;
+    }
+    
+    // Annule les effets du dernier bloc connecté (hauteur height) sur
+    // l'ensemble UTXO, les soldes et l'index
+    void disconnectTransactions(TransactionSpan transactions, uint32_t height) {
+        utxos.disconnectBlock(undoLog.back());
+        undoLog.pop_back();
+        ledger.revert(ledgerUndoLog.back());
+        ledgerUndoLog.pop_back();
+        addressIndex.disconnectBlock(transactions, height);
+    }
+    
+    // Le producteur d'un bloc PoS encaisse ses frais quand le bloc rejoint la
+    // branche active (scellé ici ou reçu) et les rend quand il la quitte
+    void creditProducer(const Block* block, bool connecting) {
+        const BlockHeader& header = block->getHeader();
+        if (header.consensus != BlockHeader::POS) return;
+        
+        Amount fees = 0;
+        for (const Transaction& tx : block->getTransactions()) fees += tx.getFee();
+        if (connecting) validators.recordBlock(header.validatorId, fees);
+        else validators.unrecordBlock(header.validatorId, fees);
+    }
+    
+    // Retire le bloc de tête de la branche active. Il reste dans l'arbre (et
+    // dans l'arène): une réorganisation ultérieure peut le reconnecter.
+    void rewindTip() {
+        creditProducer(chain.back(), false);
+        disconnectTransactions(chain.back()->getTransactions(), static_cast<uint32_t>(chain.size() - 1));
+        chain.pop_back();
+        activeNodes.pop_back();
+        
+        // Calendriers tirés d'un bloc retiré: recalculés au prochain bloc PoS,
+        // avec les stakes figés de leur époque (voir beginEpoch)
+        epochs.forgetSeededFrom(static_cast<uint32_t>(chain.size()));
+    }
+    
+    // Point de contrôle: les blocs [0, validatedHeight] ont déjà été vérifiés
+    // et chain[validatedHeight] avait pour hash validatedHash
+    mutable int validatedHeight;
+    mutable std::string validatedHash;
+    std::string checkpointFile;   // vide = point de contrôle non persisté
+    
+    // Instantané de confiance (assume-valid): blocs jusqu'à cette hauteur non
+    // revérifiés tant que chain[assumeValidHeight] a le hash attendu
+    int assumeValidHeight;
+    std::string assumeValidHash;
+    
+    // Hauteur à partir de laquelle la vérification doit reprendre
+    size_t firstUnverifiedHeight() const {
+        size_t from = 1;
+        
+        if (validatedHeight > 0 && static_cast<size_t>(validatedHeight) < chain.size() &&
+            chain[validatedHeight]->getHash() == validatedHash) {
+            from = validatedHeight + 1;
+        }
+        
+        if (assumeValidHeight > 0 && static_cast<size_t>(assumeValidHeight) < chain.size() &&
+            static_cast<size_t>(assumeValidHeight) >= from &&
+            chain[assumeValidHeight]->getHash() == assumeValidHash) {
+            from = assumeValidHeight + 1;
+        }
+        
+        return from;
+    }
+    
+    void saveCheckpoint() const {
+        if (checkpointFile.empty()) return;
+        std::ofstream out(checkpointFile);
+        out << validatedHeight << " " << validatedHash << std::endl;
+    }
+    
+    void applyPendingStakes() {
+        validators.applyStakes(pendingStakes);
+        pendingStakes.clear();
+    }
+    
+    void queueStake(ValidatorRegistry::Id id, double stake) {
+        uint64_t weight = StakeSampler::weightOf(stake);
+        if (!frozenStakes.empty()) pendingStakes.push_back({id, weight});
+        else validators.setStake(id, weight);
+    }
+    
+    // Bloc dont le hash sert de graine au calendrier planifié à l'entrée
+    // dans l'époque epoch (celui de l'époque suivante)
+    uint32_t seedHeightOf(uint32_t epoch) const { return epoch == 0 ? 0 : epochs.firstSlotOf(epoch) - 1; }
+    
+    // Entrée dans l'époque epoch: applique les changements de stake en
+    // attente, les fige et planifie l'époque suivante en arrière-plan. Au
+    // premier usage (ou après un retour en arrière), le calendrier de
+    // l'époque courante est aussi calculé, immédiatement.
+    // Les stakes figés sont gardés par époque: après un retour en arrière
+    // sous une frontière, la ré-entrée reprend le même instantané (les
+    // changements demandés depuis attendent la frontière suivante) et un
+    // calendrier recalculé retrouve ses stakes et sa graine d'origine, comme
+    // sur un nœud qui n'a pas réorganisé.
+    void beginEpoch(uint32_t epoch, bool includeCurrent) {
+        auto found = frozenStakes.find(epoch);
+        std::shared_ptr<const StakeSampler> frozen;
+        if (found != frozenStakes.end()) {
+            frozen = found->second;
+        } else {
+            applyPendingStakes();
+            frozen = std::make_shared<const StakeSampler>(validators.getStakes());
+            frozenStakes.emplace(epoch, frozen);
+        }
+        uint32_t seedHeight = seedHeightOf(epoch);
+        const SHA256::Digest& seed = chain[seedHeight]->getHashDigest();
+        
+        if (includeCurrent) {
+            // Calendrier établi à la frontière précédente, s'il y en a eu une
+            auto previous = epoch > 0 ? frozenStakes.find(epoch - 1) : frozenStakes.end();
+            if (previous != frozenStakes.end()) {
+                uint32_t previousSeed = seedHeightOf(epoch - 1);
+                epochs.plan(epoch, previousSeed, chain[previousSeed]->getHashDigest(), previous->second, false);
+            } else {
+                epochs.plan(epoch, seedHeight, seed, frozen, false);
+            }
+        }
+        epochs.plan(epoch + 1, seedHeight, seed, frozen, true);
+    }
+    
+    // Calendrier de l'époque du prochain bloc, établi au premier besoin
+    const EpochSchedule& nextSchedule() {
+        uint32_t slot = static_cast<uint32_t>(chain.size());
+        const EpochSchedule* schedule = epochs.find(epochs.epochOf(slot));
+        if (schedule == nullptr) {
+            beginEpoch(epochs.epochOf(slot), true);
+            schedule = epochs.find(epochs.epochOf(slot));
+        }
+        return *schedule;
+    }
+    
+    // Validateur élu pour le prochain bloc: simple lecture du calendrier
+    ValidatorRegistry::Id selectValidator() {
+        if (validators.empty()) return ValidatorRegistry::NONE;
+        return nextSchedule().leaderOf(static_cast<uint32_t>(chain.size()));
+    }
+    
+    // L'en-tête PoS désigne-t-il le validateur élu pour son créneau?
+    bool isElectedLeader(const BlockHeader& header) const {
+        const EpochSchedule* schedule = epochs.find(epochs.epochOf(header.index));
+        return schedule != nullptr && header.validatorId == schedule->leaderOf(header.index);
+    }
+    
+    // Cible exigée d'un bloc PoW posé sur le nœud `parent` de l'arbre (branche
+    // active ou concurrente). Les ancêtres sont demandés par profondeur
+    // croissante: la remontée reprend là où elle s'était arrêtée.
+    uint32_t expectedBits(BlockTree::NodeId parent) const {
+        BlockTree::NodeId node = parent;
+        uint32_t depth = 0;
+        auto ancestor = [&](uint32_t k) -> const BlockHeader* {
+            if (k < depth) {
+                node = parent;
+                depth = 0;
+            }
+            for (; depth < k && node != BlockTree::NONE; depth++) node = tree.get(node).parent;
+            return node == BlockTree::NONE ? nullptr : &tree.get(node).block->getHeader();
+        };
+        return retarget.nextBits(tree.get(parent).height + 1, ancestor);
+    }
+    
+    // La cible du bloc suit-elle la règle de réajustement? Contrôlé aussi en
+    // cible fixe (la cible initiale est alors exigée): sinon un bloc reçu
+    // pourrait déclarer la cible la plus facile
+    bool hasExpectedBits(const BlockHeader& header, BlockTree::NodeId parent) const {
+        return header.consensus != BlockHeader::POW || header.bits == expectedBits(parent);
+    }
+    
+    // Horodatage d'un bloc posé sur `parent`: pas avant la médiane des
+    // derniers blocs de sa branche, pas trop loin dans le futur. La cible
+    // exigée (expectedBits) étant calculée sur ces horodatages, un bloc reçu
+    // ne doit pas pouvoir les choisir librement.
+    bool hasAcceptableTimestamp(const BlockHeader& header, BlockTree::NodeId parent) const {
+        std::vector<uint32_t> previous;
+        for (BlockTree::NodeId n = parent; n != BlockTree::NONE && previous.size() < TimestampRules::MEDIAN_WINDOW;
+             n = tree.get(n).parent) {
+            previous.push_back(tree.get(n).block->getHeader().timestamp);
+        }
+        std::reverse(previous.begin(), previous.end());
+        return TimestampRules::isAcceptable(header.timestamp, TimestampRules::medianTimePast(previous),
+                                            static_cast<uint32_t>(std::time(nullptr)));
+    }
+    
+    // Poids d'un bloc dans l'arbre. Les deux unités (essais de hash, centimes
+    // de stake) ne sont pas comparables: une chaîne mêlant PoW et PoS
+    // additionne des grandeurs de nature différente.
+    uint64_t blockWeight(const BlockHeader& header) const {
+        if (header.consensus == BlockHeader::POW) return Target::work(header.bits);
+        if (header.consensus == BlockHeader::POS && header.validatorId < validators.size()) {
+            return validators.stakeOf(header.validatorId);
+        }
+        return 0;
+    }
+    
+    // Frontière d'époque: le bloc suivant ouvre une nouvelle époque
+    void checkEpochBoundary() {
+        if (epochs.isStarted() && chain.size() % epochs.getLength() == 0) {
+            beginEpoch(epochs.epochOf(static_cast<uint32_t>(chain.size())), false);
+        }
+    }
+    
+    // Fin de l'ajout d'un bloc dont les transactions sont déjà connectées:
+    // recalcul du Merkle Root, scellement (minage si validator vaut NONE,
+    // sinon signature PoS), contrôle de l'élection, puis ajout à la chaîne et
+    // à l'arbre. En cas d'échec, les effets du bloc sont annulés et sa place
+    // dans l'arène (allouée depuis marker) est rendue.
+    bool sealBlock(Block* block, const Arena::Marker& marker, ValidatorRegistry::Id validator,
+                   BlockTiming& timing) {
+        auto stage = BlockTiming::Clock::now();
+        bool merkleValid = block->hasValidMerkleRoot();
+        timing.merkle = BlockTiming::since(stage);
+        
+        bool eligible = true;
+        if (validator == ValidatorRegistry::NONE) {
+            timing.seal = block->mineBlock(expectedBits(activeNodes.back()), &timing.attempts);
+        } else {
+            timing.seal = block->validateBlock(validator, validators.nameOf(validator));
+            timing.attempts = 1;
+            
+            stage = BlockTiming::Clock::now();
+            eligible = isElectedLeader(block->getHeader());
+            timing.eligibility = BlockTiming::since(stage);
+        }
+        
+        if (!merkleValid || !eligible) {
+            std::cout << "❌ Bloc #" << block->getIndex() << " rejeté: "
+                      << (merkleValid ? "validateur non élu" : "Merkle Root invalide") << std::endl;
+            disconnectTransactions(block->getTransactions(), block->getHeader().index);
+            arena.release(marker);
+            return false;
+        }
+        
+        // La tête active est la meilleure pointe de l'arbre: son enfant le
+        // devient à son tour, sans réorganisation
+        chain.push_back(block);
+        activeNodes.push_back(tree.insert(block, activeNodes.back(), blockWeight(block->getHeader())));
+        
+        creditProducer(block, true);
+        mempool.removeForBlock(block->getTransactions());
+        lastBlockTiming = timing;
+        checkEpochBoundary();
+        return true;
+    }
+    
+    // Connecte le bloc d'un nœud de l'arbre au-dessus de la tête active. Hash,
+    // cible et Merkle Root ont été vérifiés à la réception; restent l'élection
+    // du producteur (PoS) et l'état: signatures, UTXO, soldes.
+    bool connectNode(BlockTree::NodeId id) {
+        Block* block = tree.get(id).block;
+        const BlockHeader& header = block->getHeader();
+        uint32_t height = static_cast<uint32_t>(chain.size());
+        
+        if (header.consensus == BlockHeader::POS) {
+            if (!validators.empty()) nextSchedule();
+            if (!isElectedLeader(header)) {
+                std::cout << "❌ Bloc #" << height << " rejeté: validateur non élu" << std::endl;
+                return false;
+            }
+        }
+        if (!connectTransactions(block->getTransactions(), height)) return false;
+        
+        chain.push_back(block);
+        activeNodes.push_back(id);
+        creditProducer(block, true);
+        mempool.removeForBlock(block->getTransactions());
+        checkEpochBoundary();
+        return true;
+    }
+    
+    // Aligne la branche active sur la meilleure pointe de l'arbre: seuls les
+    // blocs après le point de bifurcation sont défaits puis refaits. Un bloc
+    // refusé en route invalide sa sous-branche et le choix est refait.
+    void followBestChain() {
+        auto start = BlockTiming::Clock::now();
+        std::vector<SignedTransaction> returned;   // transactions des blocs défaits
+        size_t disconnected = 0;
+        size_t connected = 0;
+        
+        while (tree.getBest() != activeNodes.back()) {
+            BlockTree::NodeId target = tree.getBest();
+            BlockTree::NodeId fork = tree.commonAncestor(activeNodes.back(), target);
+            
+            while (activeNodes.back() != fork) {
+                TransactionSpan txs = chain.back()->getTransactions();
+                for (size_t i = 0; i < txs.size(); i++) {
+                    returned.push_back(txs.signedAt(i));
+                    mempool.add(returned.back());
+                }
+                rewindTip();
+                disconnected++;
+            }
+            
+            std::vector<BlockTree::NodeId> branch;
+            for (BlockTree::NodeId n = target; n != fork; n = tree.get(n).parent) branch.push_back(n);
+            for (auto it = branch.rbegin(); it != branch.rend(); ++it) {
+                if (!connectNode(*it)) {
+                    tree.markInvalid(*it);
+                    break;
+                }
+                connected++;
+            }
+        }
+        
+        // Les transactions défaites retournent au mempool, sauf celles dont
+        // la sortie a été dépensée par la nouvelle branche
+        for (const Transaction& tx : returned) {
+            if (!tx.isCoinbase() && !utxos.contains(tx.getInput())) mempool.remove(tx.getDigest());
+        }
+        
+        if (disconnected > 0) {
+            reorgCount++;
+            reorgDisconnected += disconnected;
+            reorgConnected += connected;
+            lastReorgMicros = BlockTiming::since(start);
+            std::cout << "🔀 Réorganisation: " << disconnected << " bloc(s) défait(s), " << connected
+                      << " refait(s) en " << lastReorgMicros << " µs" << std::endl;
+        }
+    }
+    
+    // Réception d'un bloc: vérifications sans état (hash, horodatage, cible,
+    // Merkle Root, parent connu), insertion dans l'arbre, puis choix de la branche. Ses
+    // transactions ne sont vérifiées que si sa branche devient la meilleure.
+    bool acceptBlock(Block* block) {
+        const BlockHeader& header = block->getHeader();
+        BlockTree::NodeId parent = tree.find(header.previousHash);
+        
+        const char* error = nullptr;
+        if (tree.find(block->getHashDigest()) != BlockTree::NONE) error = "déjà reçu";
+        else if (parent == BlockTree::NONE) error = "parent inconnu";
+        else if (tree.get(parent).invalid) error = "parent invalide";
+        else if (header.index != tree.get(parent).height + 1) error = "hauteur incohérente";
+        else if (!hasAcceptableTimestamp(header, parent)) error = "horodatage invalide";
+        else if (!hasExpectedBits(header, parent)) error = "cible inattendue";
+        else if (!block->isValid()) error = "hash ou cible invalide";
+        else if (!block->hasValidMerkleRoot()) error = "Merkle Root invalide";
+        if (error) {
+            std::cout << "❌ Bloc #" << header.index << " refusé: " << error << std::endl;
+            return false;
+        }
+        
+        tree.insert(block, parent, blockWeight(header));
+        followBestChain();
+        return true;
+    }
+    
+public:
+    Blockchain(int difficulty = 3)
+        : retarget(Target::fromZeroNibbles(difficulty)), bloomFalsePositiveRate(BloomFilter::DEFAULT_FALSE_POSITIVE_RATE),
+          reorgCount(0), reorgDisconnected(0), reorgConnected(0), lastReorgMicros(0),
+          validatedHeight(0), assumeValidHeight(0) {
+        // Le bloc Genesis est fixe et précalculé
+        chain.push_back(Block::createGenesis(arena));
+        activeNodes.push_back(tree.insert(chain[0], BlockTree::NONE, 0));
+        validatedHash = chain[0]->getHash();
+        connectTransactions(chain[0]->getTransactions(), 0);
+        
+        std::cout << "✅ Blockchain initialisée avec le bloc Genesis" << std::endl;
+    }
+    
+    // Ajouter un validateur
+    // Une fois les époques commencées, son stake ne compte qu'à partir de la
+    // prochaine époque (comme tout changement de stake)
+    void addValidator(const std::string& address, double stake) {
+        queueStake(validators.add(address), stake);
+    }
+    
+    // Validateur sans portefeuille (adresse synthétique, nom d'affichage)
+    void addValidator(const Address& address, const std::string& name, double stake) {
+        queueStake(validators.add(address, name), stake);
+    }
+    
+    // Modifier le stake d'un validateur: appliqué à la prochaine frontière
+    // d'époque (immédiatement tant qu'aucun calendrier n'a été établi)
+    bool updateValidatorStake(const std::string& address, double stake) {
+        return updateValidatorStake(Address::named(address), stake);
+    }
+    
+    bool updateValidatorStake(const Address& address, double stake) {
+        ValidatorRegistry::Id id = validators.find(address);
+        if (id == ValidatorRegistry::NONE) return false;
+        queueStake(id, stake);
+        return true;
+    }
+    
+    size_t getPendingStakeChanges() const { return pendingStakes.size(); }
+    uint32_t getEpochLength() const { return epochs.getLength(); }
+    
+    // Ajouter un bloc avec Proof of Work
+    long long addBlockPoW(const std::vector<SignedTransaction>& transactions) {
+        const SHA256::Digest& previousHash = chain.back()->getHashDigest();
+        int index = chain.size();
+        BlockTiming timing;
+        
+        // Double dépense et soldes vérifiés avant de miner
+        if (!connectTransactions(transactions, index, &timing)) return 0;
+        
+        Arena::Marker marker = arena.mark();
+        Block* newBlock = Block::create(arena, index, transactions, previousHash, bloomFalsePositiveRate);
+        
+        std::cout << "🔨 Mining bloc #" << index << " (PoW, cible "
+                  << Target::toString(expectedBits(activeNodes.back())) << ")..." << std::endl;
+        
+        if (!sealBlock(newBlock, marker, ValidatorRegistry::NONE, timing)) return 0;
+        
+        std::cout << "✅ Bloc miné en " << timing.seal / 1000.0 << " ms (total "
+                  << timing.total() / 1000.0 << " ms)" << std::endl;
+        timing.display();
+        
+        return timing.total();
+    }
+    
+    // Ajouter un bloc avec Proof of Stake
+    long long addBlockPoS(const std::vector<SignedTransaction>& transactions) {
+        if (validators.empty()) {
+            std::cout << "❌ Aucun validateur disponible!" << std::endl;
+            return 0;
+        }
+        
+        ValidatorRegistry::Id selected = selectValidator();
+        
+        const SHA256::Digest& previousHash = chain.back()->getHashDigest();
+        int index = chain.size();
+        BlockTiming timing;
+        
+        if (!connectTransactions(transactions, index, &timing)) return 0;
+        
+        Arena::Marker marker = arena.mark();
+        Block* newBlock = Block::create(arena, index, transactions, previousHash, bloomFalsePositiveRate);
+        
+        std::cout << "💎 Validation bloc #" << index << " (PoS) par " 
+                  << validators.nameOf(selected) << "..." << std::endl;
+        
+        if (!sealBlock(newBlock, marker, selected, timing)) return 0;
+        
+        std::cout << "✅ Bloc validé en " << timing.total() / 1000.0 << " ms" << std::endl;
+        timing.display();
+        
+        return timing.total();
+    }
+    
+    // Gabarit du mempool que connectTransactions acceptera. Le mempool ne
+    // vérifie rien à l'entrée: une transaction qui ferait échouer le bloc
+    // (signature invalide, sortie inconnue ou déjà dépensée par la chaîne,
+    // fonds insuffisants) en est retirée, et le gabarit est refait sans elle.
+    std::vector<SignedTransaction> buildValidTemplate(size_t maxBlockBytes) {
+        for (;;) {
+            std::vector<SignedTransaction> txs = mempool.buildBlockTemplate(maxBlockBytes);
+            long invalid = SignatureBatchVerifier().firstInvalid(txs);
+            if (invalid < 0) {
+                UtxoSet::BlockUndo undo;
+                size_t failed = 0;
+                if (utxos.connectBlock(txs, static_cast<uint32_t>(chain.size()), undo, nullptr, &failed)) {
+                    utxos.disconnectBlock(undo);
+                    return txs;
+                }
+                invalid = static_cast<long>(failed);
+            }
+            mempool.remove(txs[invalid].getDigest());
+        }
+    }
+    
+    // Met une transaction en attente dans le mempool
+    bool submitTransaction(const SignedTransaction& tx) {
+        return mempool.add(tx);
+    }
+    
+    // Ajoute un bloc assemblé depuis le mempool (meilleurs taux de frais d'abord)
+    long long addBlockPoWFromMempool(size_t maxBlockBytes) {
+        return addBlockPoW(buildValidTemplate(maxBlockBytes));
+    }
+    
+    // Ajout silencieux d'un bloc dont le Merkle Root est déjà calculé (import
+    // en masse); les transactions sont vérifiées comme pour tout autre bloc
+    bool appendPrepared(TransactionSpan transactions, const SHA256::Digest& merkleRoot, bool proofOfWork) {
+        if (!proofOfWork && validators.empty()) return false;
+        
+        const SHA256::Digest& previousHash = chain.back()->getHashDigest();
+        int index = chain.size();
+        BlockTiming timing;
+        if (!connectTransactions(transactions, index, &timing)) return false;
+        
+        Arena::Marker marker = arena.mark();
+        Block* newBlock = Block::createWithMerkleRoot(arena, index, transactions, merkleRoot,
+                                                      previousHash, bloomFalsePositiveRate);
+        return sealBlock(newBlock, marker, proofOfWork ? ValidatorRegistry::NONE : selectValidator(), timing);
+    }
+    
+    long long addBlockPoSFromMempool(size_t maxBlockBytes) {
+        return addBlockPoS(buildValidTemplate(maxBlockBytes));
+    }
+    
+    const Mempool& getMempool() const { return mempool; }
+    
+    // Bloc reçu d'un pair, déjà scellé: mêmes vérifications que tout bloc
+    // reçu (acceptBlock), puis choix de la branche. Sa place dans l'arène est
+    // rendue s'il est refusé.
+    bool receiveBlock(const BlockHeader& header, TransactionSpan transactions) {
+        Arena::Marker marker = arena.mark();
+        Block* block = Block::createFromHeader(arena, header, transactions, bloomFalsePositiveRate);
+        if (!acceptBlock(block)) {
+            arena.release(marker);
+            return false;
+        }
+        return true;
+    }
+    
+    // Bloc de l'arbre (toutes branches), nullptr s'il est inconnu
+    const Block* findBlock(const SHA256::Digest& hash) const {
+        BlockTree::NodeId node = tree.find(hash);
+        return node == BlockTree::NONE ? nullptr : tree.get(node).block;
+    }
+    
+    bool hasBlock(const SHA256::Digest& hash) const { return tree.find(hash) != BlockTree::NONE; }
+    
+    // Bloc miné par un autre mineur sur parentHash (pas forcément la tête
+    // active), puis reçu par ce nœud. Retourne son hash, vide s'il est refusé.
+    std::string mineBlockOn(const std::string& parentHash, const std::vector<SignedTransaction>& transactions) {
+        SHA256::Digest parentDigest;
+        BlockTree::NodeId parent = SHA256::parseHex(parentHash, parentDigest) ? tree.find(parentDigest) : BlockTree::NONE;
+        if (parent == BlockTree::NONE) {
+            std::cout << "❌ Bloc refusé: parent inconnu" << std::endl;
+            return "";
+        }
+        
+        Arena::Marker marker = arena.mark();
+        Block* block = Block::create(arena, static_cast<int>(tree.get(parent).height + 1), transactions,
+                                     parentDigest, bloomFalsePositiveRate);
+        block->mineBlock(expectedBits(parent));
+        if (!acceptBlock(block)) {
+            arena.release(marker);
+            return "";
+        }
+        return block->getHash();
+    }
+    
+    // Attestation PoS: le validateur appuie un bloc de tout son stake, qui
+    // s'ajoute au poids de la branche (une fois par validateur et par bloc)
+    bool attest(const std::string& blockHash, const std::string& validator) {
+        SHA256::Digest digest;
+        BlockTree::NodeId node = SHA256::parseHex(blockHash, digest) ? tree.find(digest) : BlockTree::NONE;
+        ValidatorRegistry::Id id = validators.find(validator);
+        if (node == BlockTree::NONE || id == ValidatorRegistry::NONE) return false;
+        if (!attestations.insert((uint64_t(node) << 32) | id).second) return false;
+        
+        tree.addWeight(node, validators.stakeOf(id));
+        followBestChain();
+        return true;
+    }
+    
+    std::string getTipHash() const { return chain.back()->getHash(); }
+    const BlockTree& getBlockTree() const { return tree; }
+    size_t getReorgCount() const { return reorgCount; }
+    
+    const UtxoSet& getUtxoSet() const { return utxos; }
+    const AccountLedger& getLedger() const { return ledger; }
+    
+    // API portefeuille: solde et historique en O(résultats), sans parcourir la chaîne
+    Amount getBalance(const Address& address) const { return ledger.balanceOf(address); }
+    
+    std::vector<const Transaction*> getHistory(const Address& address) const {
+        std::vector<const Transaction*> history;
+        for (const AddressIndex::Posting& p : addressIndex.lookup(address)) {
+            history.push_back(&chain[p.height]->getTransactions()[p.position]);
+        }
+        return history;
+    }
+    
+    // Vérifier l'intégrité de la chaîne (hash et Merkle Roots recalculés en parallèle).
+    // Seuls les blocs ajoutés depuis le dernier point de contrôle sont vérifiés,
+    // sauf si fullCheck est demandé.
+    bool isChainValid(bool fullCheck = false) const {
+        size_t from = fullCheck ? 1 : firstUnverifiedHeight();
+        
+        ValidationReport report = ParallelChainValidator().validate(chain, from,
+            [this](const BlockHeader& header) { return isElectedLeader(header); });
+        if (!report.valid) {
+            std::cout << "❌ Bloc #" << report.firstInvalidHeight << " invalide ("
+                      << report.reason << ")!" << std::endl;
+            return false;
+        }
+        
+        // Cibles réajustées: passe ordonnée, chaque bloc dépend des précédents
+        for (size_t height = from; height < chain.size(); height++) {
+            if (!hasExpectedBits(chain[height]->getHeader(), activeNodes[height - 1])) {
+                std::cout << "❌ Bloc #" << height << " invalide (cible inattendue)!" << std::endl;
+                return false;
+            }
+        }
+        
+        validatedHeight = static_cast<int>(chain.size()) - 1;
+        validatedHash = chain.back()->getHash();
+        saveCheckpoint();
+        return true;
+    }
+    
+    // Persiste le point de contrôle dans un fichier ("hauteur hash") et
+    // recharge celui qui s'y trouve déjà
+    void setCheckpointFile(const std::string& path) {
+        checkpointFile = path;
+        
+        std::ifstream in(path);
+        int height;
+        std::string hash;
+        if (in >> height >> hash) {
+            validatedHeight = height;
+            validatedHash = hash;
+        }
+    }
+    
+    // Déclare les blocs jusqu'à `height` valides (instantané de confiance)
+    void setAssumeValid(int height, const std::string& hash) {
+        assumeValidHeight = height;
+        assumeValidHash = hash;
+    }
+    
+    int getValidatedHeight() const { return validatedHeight; }
+    
+    // Vue légère de la chaîne: en-têtes seuls, corps servis à la demande
+    HeaderChain buildHeaderChain() const {
+        HeaderChain headers;
+        headers.setRetarget(retarget);
+        for (size_t i = 1; i < chain.size(); i++) {
+            if (!headers.addHeader(chain[i]->getHeader())) break;
+        }
+        headers.setBodySource([this](uint32_t height) {
+            return chain[height]->getTransactions().toVector();
+        });
+        return headers;
+    }
+    
+    // Afficher la blockchain
+    void display() const {
+        std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
+        std::cout << "║              BLOCKCHAIN - " << chain.size() << " BLOCS" 
+                  << std::string(27 - std::to_string(chain.size()).length(), ' ') << "║" << std::endl;
+        std::cout << "╚══════════════════════════════════════════════════════════════╝\n" << std::endl;
+        
+        for (const auto& block : chain) {
+            block->display();
+            std::cout << std::endl;
+        }
+    }
+    
+    // Afficher les validateurs
+    void displayValidators() const {
+        const size_t SHOWN = 10;
+        std::cout << "\n👥 VALIDATEURS (" << validators.size() << "):\n" << std::endl;
+        for (ValidatorRegistry::Id id = 0; id < validators.size() && id < SHOWN; id++) {
+            validators.display(id);
+        }
+        if (validators.size() > SHOWN) {
+            std::cout << "  … et " << validators.size() - SHOWN << " autres (stake total "
+                      << formatAmount(static_cast<Amount>(validators.totalStake())) << ")" << std::endl;
+        }
+    }
+    
+    ValidatorRegistry& getValidators() { return validators; }
+    
+    // Statistiques
+    void displayStats() const {
+        int powBlocks = 0;
+        int posBlocks = 0;
+        
+        for (const auto& block : chain) {
+            if (block->getConsensusType() == "PoW") powBlocks++;
+            else if (block->getConsensusType() == "PoS") posBlocks++;
+        }
+        
+        std::cout << "\n📊 STATISTIQUES DE LA BLOCKCHAIN:" << std::endl;
+        std::cout << "  Total blocs: " << chain.size() << std::endl;
+        std::cout << "  Blocs PoW: " << powBlocks << std::endl;
+        std::cout << "  Blocs PoS: " << posBlocks << std::endl;
+        std::cout << "  Validateurs: " << validators.size() << std::endl;
+        std::cout << "  Adresses indexées: " << addressIndex.addressCount()
+                  << " (" << addressIndex.size() << " occurrences)" << std::endl;
+        std::cout << "  Arène des blocs: " << arena.bytesUsed() << " octets en "
+                  << arena.slabCount() << " plaque(s)" << std::endl;
+        std::cout << "  Arbre de blocs: " << tree.size() << " blocs, " << tree.tipCount()
+                  << " pointe(s)" << std::endl;
+        std::cout << "  Réorganisations: " << reorgCount << " (" << reorgDisconnected << " bloc(s) défait(s), "
+                  << reorgConnected << " refait(s))" << std::endl;
+    }
+    
+    // Recherches dans l'historique: les filtres de Bloom écartent la plupart
+    // des blocs, seuls ceux qui répondent "peut-être" sont ouverts
+    struct HistoryQueryStats {
+        size_t blocksTested = 0;
+        size_t blocksOpened = 0;
+        size_t falsePositives = 0;
+    };
+    
+    std::vector<int> findBlocksInvolving(const Address& address, HistoryQueryStats* stats = nullptr) const {
+        std::vector<int> heights;
+        HistoryQueryStats local;
+        for (const Block* block : chain) {
+            local.blocksTested++;
+            if (!block->mayInvolve(address)) continue;
+            
+            local.blocksOpened++;
+            bool found = false;
+            for (const auto& tx : block->getTransactions()) {
+                if (tx.getSender() == address || tx.getReceiver() == address) {
+                    found = true;
+                    break;
+                }
+            }
+            if (found) heights.push_back(block->getIndex());
+            else local.falsePositives++;
+        }
+        if (stats) *stats = local;
+        return heights;
+    }
+    
+    // Hauteur et position d'une transaction; false si elle n'est pas dans la chaîne
+    bool findTransaction(const SHA256::Digest& txid, int& height, size_t& position,
+                         HistoryQueryStats* stats = nullptr) const {
+        HistoryQueryStats local;
+        bool found = false;
+        for (const Block* block : chain) {
+            local.blocksTested++;
+            if (!block->mayContain(txid)) continue;
+            
+            local.blocksOpened++;
+            const auto& txs = block->getTransactions();
+            for (size_t i = 0; i < txs.size() && !found; i++) {
+                if (SHA256::equal(txs[i].getDigest(), txid)) {
+                    height = block->getIndex();
+                    position = i;
+                    found = true;
+                }
+            }
+            if (found) break;
+            local.falsePositives++;
+        }
+        if (stats) *stats = local;
+        return found;
+    }
+    
+    void setBloomFalsePositiveRate(double rate) { bloomFalsePositiveRate = rate; }
+    
+    int getSize() const { return chain.size(); }
+    const BlockTiming& getLastBlockTiming() const { return lastBlockTiming; }
+    void setDifficulty(int diff) { retarget.setInitialBits(Target::fromZeroNibbles(diff)); }
+    void setRetarget(const DifficultyRetarget& rule) { retarget = rule; }
+    const DifficultyRetarget& getRetarget() const { return retarget; }
+    uint32_t getNextBits() const { return expectedBits(activeNodes.back()); }
+    
+    // Contrôle d'un bloc dont le parent est inconnu, avant de le garder en
+    // attente: hash PoW atteignant une cible au plus 4 fois plus facile que
+    // celle attendue sur la tête active (le réajustement ne varie pas plus
+    // d'une fenêtre à l'autre), ou bloc PoS d'un validateur connu
+    bool isPlausibleOrphan(const BlockHeader& header, const SHA256::Digest& hash) const {
+        if (header.consensus == BlockHeader::POS) return header.validatorId < validators.size();
+        if (header.consensus != BlockHeader::POW) return false;
+        return header.meetsDifficulty(hash) && Target::work(header.bits) >= Target::work(getNextBits()) / 4;
+    }
+};
+
+// ============================================================================
+// PARTIE 4.1: Import en masse pipeliné depuis un fichier de transactions
+// ============================================================================
+
+// File bornée entre deux étages: push bloque quand elle est pleine (contre-
+// pression sur l'étage amont), pop bloque quand elle est vide. close()
+// réveille tout le monde; pop renvoie false une fois la file vidée.
+template <typename T>
+class BoundedQueue {
+private:
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+
+public:
+    explicit BoundedQueue(size_t cap) : capacity(cap == 0 ? 1 : cap), closed(false) {}
+    
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+    
+    // Sans attente: false si la file est pleine ou fermée
+    bool tryPush(T item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed || items.size() >= capacity) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+    
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        out = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+    
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+};
+
+// Rejoue un fichier de transactions dans une chaîne. Format, une transaction
+// par ligne (les lignes vides et celles commençant par '#' sont ignorées):
+//
+//     <id> <émetteur> <destinataire> <montant> [<frais> [<id parent>:<sortie>]]
+//
+// Les montants sont décimaux ("12.50"). Sans parent, la transaction est une
+// émission: elle ouvre un nouveau bloc (une seule émission par bloc, en tête)
+// et ne peut dépasser BLOCK_SUBSIDY plus les frais de ce bloc. Sinon elle
+// dépense la sortie indiquée d'une transaction antérieure du fichier et elle
+// est signée par le portefeuille de l'émetteur.
+//
+// Étages, chacun sur ses propres threads et reliés par des files bornées:
+//   lecture → hash (txids, parents) → signature (N threads) → Merkle Root
+//   → scellement et ajout (thread appelant, dans l'ordre)
+class ChainImporter {
+public:
+    struct Options {
+        size_t blockSize = 100;
+        size_t queueCapacity = 4;
+        size_t signingThreads = std::max(1u, std::thread::hardware_concurrency());
+        bool proofOfWork = true;
+    };
+    
+    struct Report {
+        size_t lines = 0;
+        size_t parseErrors = 0;
+        size_t transactions = 0;
+        size_t blocks = 0;
+        size_t rejectedBlocks = 0;
+        double seconds = 0;
+        // Temps de travail cumulé par étage (hors attente), en µs
+        long long parseMicros = 0;
+        long long hashMicros = 0;
+        long long signMicros = 0;
+        long long merkleMicros = 0;
+        long long appendMicros = 0;
+    };
+
+private:
+    struct RawTransaction {
+        uint32_t id;
+        std::string sender;
+        std::string receiver;
+        Amount amount;
+        Amount fee;
+        bool spends;
+        uint32_t parentId;
+        uint32_t parentIndex;
+    };
+    
+    struct Batch {
+        uint64_t sequence = 0;
+        std::vector<RawTransaction> raw;
+        std::vector<SignedTransaction> txs;
+        SHA256::Digest merkleRoot = {};
+    };
+    
+    Blockchain& chain;
+    Options options;
+    
+    using Clock = std::chrono::steady_clock;
+    
+    static long long microsSince(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    }
+    
+    // "12.5" → 1250 unités, sans passer par un flottant. Accumulé chiffre
+    // par chiffre: un montant hors de Amount est une ligne invalide (ni
+    // exception dans le thread de lecture, ni débordement)
+    static bool parseAmount(const std::string& text, Amount& out) {
+        size_t dot = text.find('.');
+        std::string whole = text.substr(0, dot);
+        std::string cents = (dot == std::string::npos) ? "" : text.substr(dot + 1);
+        if (whole.empty() || cents.size() > 2) return false;
+        for (char c : whole + cents) {
+            if (c < '0' || c > '9') return false;
+        }
+        while (cents.size() < 2) cents += '0';
+        
+        const Amount limit = (std::numeric_limits<Amount>::max() - (COIN - 1)) / COIN;
+        Amount units = 0;
+        for (char c : whole) {
+            int digit = c - '0';
+            if (units > (limit - digit) / 10) return false;
+            units = units * 10 + digit;
+        }
+        out = units * COIN + (cents[0] - '0') * 10 + (cents[1] - '0');
+        return true;
+    }
+    
+    static bool parseLine(const std::string& line, RawTransaction& tx) {
+        std::istringstream fields(line);
+        std::string amount, fee = "0", parent;
+        if (!(fields >> tx.id >> tx.sender >> tx.receiver >> amount)) return false;
+        fields >> fee >> parent;
+        if (!parseAmount(amount, tx.amount) || !parseAmount(fee, tx.fee)) return false;
+        
+        tx.spends = !parent.empty();
+        tx.parentId = tx.parentIndex = 0;
+        if (tx.spends) {
+            size_t colon = parent.find(':');
+            if (colon == std::string::npos) return false;
+            try {
+                unsigned long id = std::stoul(parent.substr(0, colon));
+                unsigned long index = std::stoul(parent.substr(colon + 1));
+                if (id > std::numeric_limits<uint32_t>::max() || index > std::numeric_limits<uint32_t>::max()) return false;
+                tx.parentId = static_cast<uint32_t>(id);
+                tx.parentIndex = static_cast<uint32_t>(index);
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    ChainImporter(Blockchain& target, const Options& opts) : chain(target), options(opts) {}
+    
+    Report run(std::istream& input) {
+        Report report;
+        auto start = Clock::now();
+        
+        BoundedQueue<Batch> parsed(options.queueCapacity);
+        BoundedQueue<Batch> hashed(options.queueCapacity);
+        BoundedQueue<Batch> signedBatches(options.queueCapacity);
+        BoundedQueue<Batch> sealed(options.queueCapacity);
+        std::atomic<long long> signMicros(0);
+        
+        // Étage 1: lecture et analyse des lignes
+        std::thread reader([&] {
+            Batch batch;
+            uint64_t sequence = 0;
+            std::string line;
+            auto flush = [&] {
+                batch.sequence = sequence++;
+                parsed.push(std::move(batch));
+                batch = Batch();
+            };
+            while (true) {
+                bool more = static_cast<bool>(std::getline(input, line));
+                auto t = Clock::now();
+                if (!more) break;
+                report.lines++;
+                if (line.empty() || line[0] == '#') continue;
+                
+                RawTransaction tx;
+                if (!parseLine(line, tx)) {
+                    report.parseErrors++;
+                    continue;
+                }
+                if (!tx.spends && !batch.raw.empty()) flush();
+                batch.raw.push_back(std::move(tx));
+                report.parseMicros += microsSince(t);
+                if (batch.raw.size() == options.blockSize) flush();
+            }
+            if (!batch.raw.empty()) flush();
+            parsed.close();
+        });
+        
+        // Étage 2: construction des transactions et de leur txid (mémorisé),
+        // résolution des parents; séquentiel car un parent doit être haché avant
+        std::thread hasher([&] {
+            std::unordered_map<uint32_t, SHA256::Digest> txids;
+            Batch batch;
+            while (parsed.pop(batch)) {
+                auto t = Clock::now();
+                batch.txs.reserve(batch.raw.size());
+                for (const RawTransaction& raw : batch.raw) {
+                    OutPoint input;
+                    if (raw.spends) {
+                        auto parent = txids.find(raw.parentId);
+                        if (parent != txids.end()) input.txid = parent->second;
+                        input.index = raw.parentIndex;
+                    }
+                    batch.txs.push_back(Transaction(raw.id, Address::named(raw.sender),
+                                                    Address::named(raw.receiver), raw.amount, raw.fee, input));
+                    txids[raw.id] = batch.txs.back().getDigest();
+                }
+                report.hashMicros += microsSince(t);
+                hashed.push(std::move(batch));
+            }
+            hashed.close();
+        });
+        
+        // Étage 3: signatures des dépenses, en parallèle (ordre rétabli plus loin)
+        std::vector<std::thread> signers;
+        std::atomic<size_t> activeSigners(options.signingThreads);
+        for (size_t w = 0; w < options.signingThreads; w++) {
+            signers.emplace_back([&] {
+                Batch batch;
+                while (hashed.pop(batch)) {
+                    auto t = Clock::now();
+                    for (size_t i = 0; i < batch.txs.size(); i++) {
+                        if (!batch.txs[i].isCoinbase()) {
+                            batch.txs[i] = batch.txs[i].signedWith(Wallet::keyFor(batch.raw[i].sender));
+                        }
+                    }
+                    signMicros += microsSince(t);
+                    signedBatches.push(std::move(batch));
+                }
+                if (--activeSigners == 0) signedBatches.close();
+            });
+        }
+        
+        // Étage 4: remise en ordre et Merkle Root
+        std::thread merkle([&] {
+            std::map<uint64_t, Batch> pending;
+            uint64_t next = 0;
+            Batch batch;
+            while (signedBatches.pop(batch)) {
+                pending.emplace(batch.sequence, std::move(batch));
+                for (auto it = pending.find(next); it != pending.end(); it = pending.find(next)) {
+                    auto t = Clock::now();
+                    it->second.merkleRoot = Block::computeMerkleRoot(it->second.txs);
+                    report.merkleMicros += microsSince(t);
+                    sealed.push(std::move(it->second));
+                    pending.erase(it);
+                    next++;
+                }
+            }
+            sealed.close();
+        });
+        
+        // Étage 5: scellement (minage ou validation) et ajout, dans l'ordre
+        Batch batch;
+        while (sealed.pop(batch)) {
+            auto t = Clock::now();
+            if (chain.appendPrepared(batch.txs, batch.merkleRoot, options.proofOfWork)) {
+                report.blocks++;
+                report.transactions += batch.txs.size();
+            } else {
+                report.rejectedBlocks++;
+            }
+            report.appendMicros += microsSince(t);
+        }
+        
+        reader.join();
+        hasher.join();
+        for (auto& signer : signers) signer.join();
+        merkle.join();
+        
+        report.signMicros = signMicros;
+        report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return report;
+    }
+};
+
+// Mode ligne de commande: --import <fichier> [transactions par bloc] [difficulté]
+int runImport(const std::string& path, size_t blockSize, int difficulty) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "❌ Impossible d'ouvrir " << path << std::endl;
+        return 1;
+    }
+    
+    Blockchain blockchain(difficulty);
+    ChainImporter::Options options;
+    options.blockSize = std::max<size_t>(blockSize, 1);
+    
+    std::cout << "📦 Import de " << path << " (" << options.blockSize << " transactions par bloc, "
+              << options.signingThreads << " thread(s) de signature)..." << std::endl;
+    ChainImporter::Report report = ChainImporter(blockchain, options).run(file);
+    
+    std::cout << "✅ " << report.transactions << " transactions en " << report.blocks << " blocs ("
+              << report.rejectedBlocks << " bloc(s) rejeté(s), " << report.parseErrors
+              << " ligne(s) invalide(s)) en " << std::fixed << std::setprecision(3) << report.seconds
+              << " s, soit " << std::setprecision(0) << report.transactions / std::max(report.seconds, 1e-9)
+              << " tx/s" << std::endl;
+    std::cout << "   Travail par étage (ms): lecture " << report.parseMicros / 1000
+              << ", hash " << report.hashMicros / 1000
+              << ", signature " << report.signMicros / 1000
+              << ", Merkle " << report.merkleMicros / 1000
+              << ", scellement+ajout " << report.appendMicros / 1000 << std::endl;
+    std::cout << "   Chaîne " << (blockchain.isChainValid() ? "valide ✓" : "INVALIDE ✗")
+              << ", " << blockchain.getSize() << " blocs" << std::endl;
+    return 0;
+}
+
+// ============================================================================
+// PARTIE 4.2: Réseau de nœuds (canaux en mémoire ou TCP local)
+// ============================================================================
+
+// Messages échangés entre nœuds, encadrés sur le fil par
+//     type(1) | longueur de la charge(4, little-endian) | charge
+// Un nœud annonce (INV) ce qu'il vient d'accepter; un pair qui ne le connaît
+// pas le demande (GET) à celui qui l'a annoncé et reçoit l'objet complet:
+//   INV_*, GET_*: hash(32)
+//   TX:           transaction encodée (Transaction::SERIALIZED_SIZE)
+//   BLOCK:        en-tête(85) | nombre de transactions(4) | transactions
+struct WireMessage {
+    enum Type : uint8_t { INV_BLOCK = 1, INV_TX, GET_BLOCK, GET_TX, BLOCK, TX };
+    static constexpr size_t HEADER_SIZE = 5;
+    // Plus gros bloc relayé; une charge plus longue ne peut être valide et
+    // est refusée avant toute allocation
+    static constexpr size_t MAX_BLOCK_TRANSACTIONS = 10000;
+    static constexpr size_t MAX_PAYLOAD = BlockHeader::SERIALIZED_SIZE + 4 + MAX_BLOCK_TRANSACTIONS * Transaction::SERIALIZED_SIZE;
+    
+    static void putU32(uint8_t* out, uint32_t v) {
+        for (int i = 0; i < 4; i++) out[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+    
+    static uint32_t getU32(const uint8_t* in) {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) v |= uint32_t(in[i]) << (8 * i);
+        return v;
+    }
+    
+    // Trame vide de payloadSize octets, en-tête rempli
+    static std::vector<uint8_t> frame(Type type, size_t payloadSize) {
+        std::vector<uint8_t> out(HEADER_SIZE + payloadSize);
+        out[0] = type;
+        putU32(out.data() + 1, static_cast<uint32_t>(payloadSize));
+        return out;
+    }
+    
+    static std::vector<uint8_t> hashMessage(Type type, const SHA256::Digest& hash) {
+        std::vector<uint8_t> out = frame(type, hash.size());
+        std::copy(hash.begin(), hash.end(), out.begin() + HEADER_SIZE);
+        return out;
+    }
+    
+    static std::vector<uint8_t> transaction(const SignedTransaction& tx) {
+        std::vector<uint8_t> out = frame(TX, Transaction::SERIALIZED_SIZE);
+        tx.encode(out.data() + HEADER_SIZE);
+        return out;
+    }
+    
+    static std::vector<uint8_t> block(const Block& block) {
+        TransactionSpan txs = block.getTransactions();
+        std::vector<uint8_t> out = frame(BLOCK, BlockHeader::SERIALIZED_SIZE + 4 + txs.size() * Transaction::SERIALIZED_SIZE);
+        uint8_t* pos = out.data() + HEADER_SIZE;
+        auto header = block.getHeader().serialize();
+        pos = std::copy(header.begin(), header.end(), pos);
+        putU32(pos, static_cast<uint32_t>(txs.size()));
+        pos += 4;
+        for (size_t i = 0; i < txs.size(); i++) {
+            SignedTransaction::encode(txs[i], txs.witnessAt(i), pos);
+            pos += Transaction::SERIALIZED_SIZE;
+        }
+        return out;
+    }
+    
+    static SHA256::Digest hashOf(const uint8_t* payload) {
+        SHA256::Digest hash;
+        std::copy(payload, payload + hash.size(), hash.begin());
+        return hash;
+    }
+};
+
+// Mesures de propagation partagées par tous les nœuds d'une simulation:
+// pour chaque objet (bloc ou transaction), instant de sa création, délai
+// d'arrivée et coût de validation sur chaque nœud atteint, et octets émis
+// sur le fil à son sujet (annonces, demandes et objet lui-même)
+class PropagationLog {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Record {
+        Clock::time_point origin;
+        std::vector<long long> arrivals;      // µs depuis l'origine (0 pour le nœud d'origine)
+        std::vector<long long> validations;   // µs de validation à la réception
+        uint64_t wireBytes = 0;
+        uint64_t messages = 0;
+    };
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::unordered_map<SHA256::Digest, Record, DigestHash> records;
+
+public:
+    void recordOrigin(const SHA256::Digest& hash) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Record& r = records[hash];
+        r.origin = Clock::now();
+        r.arrivals.push_back(0);
+        changed.notify_all();
+    }
+    
+    void recordArrival(const SHA256::Digest& hash, long long validationMicros) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Record& r = records[hash];
+        r.arrivals.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - r.origin).count());
+        r.validations.push_back(validationMicros);
+        changed.notify_all();
+    }
+    
+    void recordWire(const SHA256::Digest& hash, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Record& r = records[hash];
+        r.wireBytes += bytes;
+        r.messages++;
+    }
+    
+    // Attend que l'objet ait atteint nodeCount nœuds (false au délai dépassé)
+    bool waitUntil(const SHA256::Digest& hash, size_t nodeCount, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, timeout, [&] {
+            auto it = records.find(hash);
+            return it != records.end() && it->second.arrivals.size() >= nodeCount;
+        });
+    }
+    
+    Record get(const SHA256::Digest& hash) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = records.find(hash);
+        return it == records.end() ? Record() : it->second;
+    }
+};
+
+// Lien vers un pair. send ne dépend jamais du traitement chez le pair: la
+// trame est remise dans sa file d'entrée (en mémoire) ou dans le socket.
+class PeerLink {
+public:
+    virtual ~PeerLink() = default;
+    virtual void send(const std::vector<uint8_t>& frame) = 0;
+    virtual void close() {}
+};
+
+// Nœud complet: sa propre Blockchain (PoW), un thread qui traite les trames
+// reçues dans l'ordre d'arrivée, et des liens vers ses pairs. Un objet
+// accepté est annoncé à tous les pairs sauf celui qui l'a envoyé; un bloc
+// dont le parent manque est mis de côté et le parent est demandé.
+class NetworkNode {
+public:
+    struct Traffic {
+        uint64_t bytesSent = 0;
+        uint64_t bytesReceived = 0;
+        uint64_t messagesSent = 0;
+        uint64_t messagesReceived = 0;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    static constexpr size_t NO_PEER = static_cast<size_t>(-1);
+    static constexpr size_t INBOX_FRAMES = 1 << 16;
+    static constexpr size_t INBOX_BYTES = 64 << 20;
+    static constexpr size_t MAX_ORPHANS_PER_PEER = 64;
+    static constexpr auto ORPHAN_EXPIRY = std::chrono::seconds(60);
+    static constexpr auto REQUEST_TIMEOUT = std::chrono::seconds(5);
+    
+    struct Inbound {
+        size_t peer;
+        std::vector<uint8_t> frame;
+    };
+    
+    struct Orphan {
+        size_t peer;
+        Clock::time_point received;
+        SHA256::Digest parent;
+        std::vector<uint8_t> frame;
+    };
+    
+    size_t id;
+    PropagationLog& log;
+    Blockchain chain;
+    std::mutex chainMutex;      // la chaîne est aussi utilisée par mine et submit
+    std::vector<std::unique_ptr<PeerLink>> peers;
+    // File d'entrée bornée en trames et en octets. Un nœud lent ne doit
+    // jamais bloquer le thread (ou le socket) d'un pair qui lui écrit: au-delà
+    // des bornes, les trames reçues sont abandonnées
+    BoundedQueue<Inbound> inbox;
+    std::atomic<size_t> inboxBytes;
+    std::thread worker;
+    
+    // État du protocole, touché par le seul thread de traitement. Une demande
+    // sans réponse expire après REQUEST_TIMEOUT (l'objet peut alors être
+    // redemandé), un orphelin après ORPHAN_EXPIRY.
+    std::unordered_map<SHA256::Digest, Clock::time_point, DigestHash> requested;   // blocs et transactions demandés
+    std::unordered_map<SHA256::Digest, Orphan, DigestHash> orphans;                // hash → bloc sans parent connu
+    std::unordered_multimap<SHA256::Digest, SHA256::Digest, DigestHash> orphansByParent;
+    std::vector<size_t> orphansPerPeer;
+    Clock::time_point nextSweep;
+    
+    std::atomic<uint64_t> bytesSent, bytesReceived, messagesSent, messagesReceived;
+    
+    // subject: bloc ou transaction dont parle la trame (compte de ses octets)
+    void sendTo(size_t peer, const std::vector<uint8_t>& frame, const SHA256::Digest& subject) {
+        peers[peer]->send(frame);
+        bytesSent += frame.size();
+        messagesSent++;
+        log.recordWire(subject, frame.size());
+    }
+    
+    // Marque hash comme demandé; false si une demande est encore en cours
+    bool request(const SHA256::Digest& hash) {
+        Clock::time_point now = Clock::now();
+        auto it = requested.find(hash);
+        if (it != requested.end() && now - it->second < REQUEST_TIMEOUT) return false;
+        requested[hash] = now;
+        return true;
+    }
+    
+    void announce(WireMessage::Type type, const SHA256::Digest& hash, size_t except) {
+        std::vector<uint8_t> frame = WireMessage::hashMessage(type, hash);
+        for (size_t p = 0; p < peers.size(); p++) {
+            if (p != except) sendTo(p, frame, hash);
+        }
+    }
+    
+    void handle(size_t from, const std::vector<uint8_t>& frame) {
+        if (frame.size() < WireMessage::HEADER_SIZE) return;
+        const uint8_t* payload = frame.data() + WireMessage::HEADER_SIZE;
+        size_t size = frame.size() - WireMessage::HEADER_SIZE;
+        
+        switch (frame[0]) {
+            case WireMessage::INV_BLOCK:
+            case WireMessage::INV_TX: {
+                if (size != sizeof(SHA256::Digest)) return;
+                SHA256::Digest hash = WireMessage::hashOf(payload);
+                bool isBlock = frame[0] == WireMessage::INV_BLOCK;
+                bool known;
+                {
+                    std::lock_guard<std::mutex> lock(chainMutex);
+                    known = isBlock ? chain.hasBlock(hash) : chain.getMempool().contains(hash);
+                }
+                if (known || !request(hash)) return;
+                sendTo(from, WireMessage::hashMessage(isBlock ? WireMessage::GET_BLOCK : WireMessage::GET_TX, hash),
+                       hash);
+                break;
+            }
+            case WireMessage::GET_BLOCK: {
+                if (size != sizeof(SHA256::Digest)) return;
+                SHA256::Digest hash = WireMessage::hashOf(payload);
+                std::vector<uint8_t> reply;
+                {
+                    std::lock_guard<std::mutex> lock(chainMutex);
+                    const Block* block = chain.findBlock(hash);
+                    if (block) reply = WireMessage::block(*block);
+                }
+                if (!reply.empty()) sendTo(from, reply, hash);
+                break;
+            }
+            case WireMessage::GET_TX: {
+                if (size != sizeof(SHA256::Digest)) return;
+                SHA256::Digest hash = WireMessage::hashOf(payload);
+                std::vector<uint8_t> reply;
+                {
+                    std::lock_guard<std::mutex> lock(chainMutex);
+                    const SignedTransaction* tx = chain.getMempool().find(hash);
+                    if (tx) reply = WireMessage::transaction(*tx);
+                }
+                if (!reply.empty()) sendTo(from, reply, hash);
+                break;
+            }
+            case WireMessage::TX: {
+                if (size != Transaction::SERIALIZED_SIZE) return;
+                SignedTransaction tx = SignedTransaction::decode(payload);
+                requested.erase(tx.getDigest());
+                
+                // Seule la signature est vérifiée avant le relais; la dépense
+                // elle-même l'est quand la transaction entre dans un bloc
+                auto start = BlockTiming::Clock::now();
+                bool valid = SignatureBatchVerifier(nullptr).verifyAll(TransactionSpan(&tx, 1));
+                long long micros = BlockTiming::since(start);
+                if (!valid) return;
+                
+                bool added;
+                {
+                    std::lock_guard<std::mutex> lock(chainMutex);
+                    added = chain.submitTransaction(tx);
+                }
+                if (!added) return;
+                log.recordArrival(tx.getDigest(), micros);
+                announce(WireMessage::INV_TX, tx.getDigest(), from);
+                break;
+            }
+            case WireMessage::BLOCK:
+                receiveBlock(from, frame);
+                break;
+        }
+    }
+    
+    // Bloc complet reçu de `from`, puis les orphelins qui l'attendaient, par
+    // une liste de travail (pas de récursion sur une longue lignée)
+    void receiveBlock(size_t from, const std::vector<uint8_t>& frame) {
+        std::vector<std::pair<size_t, std::vector<uint8_t>>> pending;
+        SHA256::Digest hash;
+        if (!acceptFrame(from, frame, hash)) return;
+        adoptOrphansOf(hash, pending);
+        
+        while (!pending.empty()) {
+            std::pair<size_t, std::vector<uint8_t>> child = std::move(pending.back());
+            pending.pop_back();
+            if (acceptFrame(child.first, child.second, hash)) adoptOrphansOf(hash, pending);
+        }
+    }
+    
+    // Validation (en-tête, signatures, UTXO) chronométrée d'une trame BLOCK.
+    // Un bloc dont le parent est inconnu n'est gardé que s'il est plausible
+    // (hash et cible, voir Blockchain::isPlausibleOrphan), dans la limite de
+    // MAX_ORPHANS_PER_PEER par pair. true si le bloc a été accepté.
+    bool acceptFrame(size_t from, const std::vector<uint8_t>& frame, SHA256::Digest& hash) {
+        const uint8_t* payload = frame.data() + WireMessage::HEADER_SIZE;
+        size_t size = frame.size() - WireMessage::HEADER_SIZE;
+        if (size < BlockHeader::SERIALIZED_SIZE + 4) return false;
+        
+        BlockHeader header = BlockHeader::deserialize(payload);
+        size_t count = WireMessage::getU32(payload + BlockHeader::SERIALIZED_SIZE);
+        if (count > WireMessage::MAX_BLOCK_TRANSACTIONS) return false;
+        if (size != BlockHeader::SERIALIZED_SIZE + 4 + count * Transaction::SERIALIZED_SIZE) return false;
+        hash = header.computeHash();
+        requested.erase(hash);
+        
+        bool accepted = false;
+        bool orphan = false;
+        bool plausible = false;
+        long long micros = 0;
+        {
+            std::lock_guard<std::mutex> lock(chainMutex);
+            if (chain.hasBlock(hash)) return false;
+            if (!chain.hasBlock(header.previousHash)) {
+                orphan = true;
+                plausible = chain.isPlausibleOrphan(header, hash);
+            } else {
+                std::vector<SignedTransaction> txs;
+                txs.reserve(count);
+                const uint8_t* pos = payload + BlockHeader::SERIALIZED_SIZE + 4;
+                for (size_t i = 0; i < count; i++, pos += Transaction::SERIALIZED_SIZE) {
+                    txs.push_back(SignedTransaction::decode(pos));
+                }
+                auto start = BlockTiming::Clock::now();
+                accepted = chain.receiveBlock(header, txs);
+                micros = BlockTiming::since(start);
+            }
+        }
+        
+        if (orphan) {
+            if (!plausible || orphans.count(hash) || orphansPerPeer[from] >= MAX_ORPHANS_PER_PEER) return false;
+            orphans.emplace(hash, Orphan{from, Clock::now(), header.previousHash, frame});
+            orphansByParent.emplace(header.previousHash, hash);
+            orphansPerPeer[from]++;
+            if (request(header.previousHash)) {
+                sendTo(from, WireMessage::hashMessage(WireMessage::GET_BLOCK, header.previousHash), header.previousHash);
+            }
+            return false;
+        }
+        if (!accepted) return false;
+        
+        log.recordArrival(hash, micros);
+        announce(WireMessage::INV_BLOCK, hash, from);
+        return true;
+    }
+    
+    // Retire les orphelins enfants de `parent` et les ajoute à `pending`
+    void adoptOrphansOf(const SHA256::Digest& parent, std::vector<std::pair<size_t, std::vector<uint8_t>>>& pending) {
+        auto range = orphansByParent.equal_range(parent);
+        for (auto it = range.first; it != range.second; ++it) {
+            auto orphan = orphans.find(it->second);
+            if (orphan == orphans.end()) continue;
+            pending.emplace_back(orphan->second.peer, std::move(orphan->second.frame));
+            orphansPerPeer[orphan->second.peer]--;
+            orphans.erase(orphan);
+        }
+        orphansByParent.erase(range.first, range.second);
+    }
+    
+    // Oublie les demandes restées sans réponse et les orphelins trop anciens
+    void expire() {
+        Clock::time_point now = Clock::now();
+        if (now < nextSweep) return;
+        nextSweep = now + std::chrono::seconds(1);
+        
+        for (auto it = requested.begin(); it != requested.end();) {
+            it = (now - it->second >= REQUEST_TIMEOUT) ? requested.erase(it) : std::next(it);
+        }
+        for (auto it = orphans.begin(); it != orphans.end();) {
+            if (now - it->second.received < ORPHAN_EXPIRY) {
+                ++it;
+                continue;
+            }
+            auto range = orphansByParent.equal_range(it->second.parent);
+            for (auto child = range.first; child != range.second; ++child) {
+                if (SHA256::equal(child->second, it->first)) {
+                    orphansByParent.erase(child);
+                    break;
+                }
+            }
+            orphansPerPeer[it->second.peer]--;
+            it = orphans.erase(it);
+        }
+    }
+    
+    void run() {
+        Inbound message;
+        while (inbox.pop(message)) {
+            inboxBytes -= message.frame.size();
+            handle(message.peer, message.frame);
+            expire();
+        }
+    }
+
+public:
+    NetworkNode(size_t nodeId, PropagationLog& propagation, int difficulty = 2)
+        : id(nodeId), log(propagation), chain(difficulty), inbox(INBOX_FRAMES), inboxBytes(0),
+          bytesSent(0), bytesReceived(0), messagesSent(0), messagesReceived(0) {}
+    
+    ~NetworkNode() { stop(); }
+    
+    NetworkNode(const NetworkNode&) = delete;
+    NetworkNode& operator=(const NetworkNode&) = delete;
+    
+    // Les liens sont ajoutés avant start(), la liste des pairs est ensuite figée
+    size_t addPeer(std::unique_ptr<PeerLink> link) {
+        peers.push_back(std::move(link));
+        return peers.size() - 1;
+    }
+    
+    size_t peerCount() const { return peers.size(); }
+    size_t getId() const { return id; }
+    
+    void start() {
+        orphansPerPeer.assign(peers.size(), 0);
+        worker = std::thread([this] { run(); });
+    }
+    
+    // Ferme la file d'entrée (les trames en attente sont perdues) et attend
+    // le thread de traitement, qui peut être en train d'écrire sur un lien:
+    // les liens ne sont fermés qu'ensuite
+    void stop() {
+        inbox.close();
+        if (worker.joinable()) worker.join();
+        for (auto& peer : peers) peer->close();
+    }
+    
+    // Point d'entrée des transports (appelé depuis le thread d'un lien ou
+    // d'un pair). Ne bloque jamais: la trame est abandonnée si la file est pleine.
+    void deliver(size_t peer, std::vector<uint8_t> frame) {
+        size_t bytes = frame.size();
+        bytesReceived += bytes;
+        messagesReceived++;
+        if (inboxBytes.fetch_add(bytes) + bytes > INBOX_BYTES || !inbox.tryPush(Inbound{peer, std::move(frame)})) {
+            inboxBytes -= bytes;
+        }
+    }
+    
+    // Mine localement un bloc sur la tête active et l'annonce (hash: celui
+    // du bloc). Retourne false s'il est refusé ou
+    // dépasse WireMessage::MAX_BLOCK_TRANSACTIONS.
+    bool mine(const std::vector<SignedTransaction>& txs, SHA256::Digest& hash) {
+        if (txs.size() > WireMessage::MAX_BLOCK_TRANSACTIONS) return false;
+        {
+            std::lock_guard<std::mutex> lock(chainMutex);
+            if (!chain.appendPrepared(txs, Block::computeMerkleRoot(txs), true)) return false;
+            hash = SHA256::fromHex(chain.getTipHash().c_str());
+        }
+        log.recordOrigin(hash);
+        announce(WireMessage::INV_BLOCK, hash, NO_PEER);
+        return true;
+    }
+    
+    // Met une transaction dans le mempool local et l'annonce
+    bool submit(const SignedTransaction& tx) {
+        bool added;
+        {
+            std::lock_guard<std::mutex> lock(chainMutex);
+            added = chain.submitTransaction(tx);
+        }
+        if (!added) return false;
+        log.recordOrigin(tx.getDigest());
+        announce(WireMessage::INV_TX, tx.getDigest(), NO_PEER);
+        return true;
+    }
+    
+    std::string getTipHash() {
+        std::lock_guard<std::mutex> lock(chainMutex);
+        return chain.getTipHash();
+    }
+    
+    Traffic getTraffic() const {
+        Traffic t;
+        t.bytesSent = bytesSent;
+        t.bytesReceived = bytesReceived;
+        t.messagesSent = messagesSent;
+        t.messagesReceived = messagesReceived;
+        return t;
+    }
+};
+
+// Canal en mémoire: la trame est copiée directement dans la file d'entrée du pair
+class MemoryLink : public PeerLink {
+private:
+    NetworkNode& target;
+    size_t targetPeer;      // indice de ce lien vu depuis le pair
+
+public:
+    MemoryLink(NetworkNode& t, size_t peer) : target(t), targetPeer(peer) {}
+    
+    void send(const std::vector<uint8_t>& frame) override { target.deliver(targetPeer, frame); }
+};
+
+// Connexion TCP sur 127.0.0.1 (TCP_NODELAY): un thread lit les trames du
+// socket et les remet au nœud propriétaire; les envois sont sérialisés
+class TcpLink : public PeerLink {
+private:
+    int fd;
+    NetworkNode& owner;
+    size_t ownerPeer;       // indice de ce lien chez le propriétaire
+    std::mutex sendMutex;
+    std::thread reader;
     
-    std::string toString() const {
-        std::stringstream ss;
-        ss << id << sender << receiver << std::fixed << std::setprecision(2) << amount;
-        return ss.str();
+    bool readFully(uint8_t* out, size_t size) {
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = ::recv(fd, out + done, size - done, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            done += static_cast<size_t>(n);
+        }
+        return true;
     }
     
-    std::string getHash() const {
-        return SHA256::hash(toString());
+    void readLoop() {
+        uint8_t header[WireMessage::HEADER_SIZE];
+        while (readFully(header, sizeof(header))) {
+            // Longueur annoncée par le pair: bornée avant d'allouer, le lien
+            // est abandonné au-delà
+            uint32_t length = WireMessage::getU32(header + 1);
+            if (length > WireMessage::MAX_PAYLOAD) break;
+            std::vector<uint8_t> frame(WireMessage::HEADER_SIZE + length);
+            std::copy(header, header + sizeof(header), frame.begin());
+            if (!readFully(frame.data() + sizeof(header), frame.size() - sizeof(header))) break;
+            owner.deliver(ownerPeer, std::move(frame));
+        }
     }
-    
-    void display() const {
-        std::cout << "  [" << id << "] " << sender << " → " << receiver 
-                  << " : " << std::fixed << std::setprecision(2) << amount << " coins" << std::endl;
+
+public:
+    TcpLink(int socketFd, NetworkNode& node, size_t peer) : fd(socketFd), owner(node), ownerPeer(peer) {
+        reader = std::thread([this] { readLoop(); });
     }
     
-    std::string getId() const { return id; }
-    std::string getSender() const { return sender; }
-    std::string getReceiver() const { return receiver; }
-    double getAmount() const { return amount; }
-};
-
-class MerkleTree {
-private:
-    std::string root;
+    ~TcpLink() override { close(); }
     
-    std::string combineHashes(const std::string& left, const std::string& right) {
-        return SHA256::hash(left + right);
+    void send(const std::vector<uint8_t>& frame) override {
+        std::lock_guard<std::mutex> lock(sendMutex);
+        if (fd < 0) return;
+        size_t done = 0;
+        while (done < frame.size()) {
+            ssize_t n = ::send(fd, frame.data() + done, frame.size() - done, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return;   // pair déconnecté
+            done += static_cast<size_t>(n);
+        }
     }
     
-    std::string buildTree(std::vector<std::string>& hashes) {
-        if (hashes.empty()) return "";
-        if (hashes.size() == 1) return hashes[0];
-        
-        std::vector<std::string> parentHashes;
-        
-        for (size_t i = 0; i < hashes.size(); i += 2) {
-            if (i + 1 < hashes.size()) {
-                parentHashes.push_back(combineHashes(hashes[i], hashes[i + 1]));
-            } else {
-                parentHashes.push_back(combineHashes(hashes[i], hashes[i]));
-            }
+    // fd n'est modifié que sous sendMutex: un send concurrent ne peut pas
+    // écrire sur un descripteur fermé puis réattribué
+    void close() override {
+        int socketFd;
+        {
+            std::lock_guard<std::mutex> lock(sendMutex);
+            socketFd = fd;
         }
+        if (socketFd < 0) return;
+        ::shutdown(socketFd, SHUT_RDWR);   // débloque le lecteur et un send en cours
+        if (reader.joinable()) reader.join();
         
-        return buildTree(parentHashes);
+        std::lock_guard<std::mutex> lock(sendMutex);
+        ::close(fd);
+        fd = -1;
     }
     
-public:
-    MerkleTree() : root("") {}
-    
-    void build(const std::vector<Transaction>& transactions) {
-        if (transactions.empty()) {
-            root = "";
-            return;
-        }
+    // Paire de sockets connectés l'un à l'autre via un port éphémère de 127.0.0.1
+    static bool openLoopbackPair(int& a, int& b) {
+        a = b = -1;
+        int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listener < 0) return false;
         
-        std::vector<std::string> hashes;
-        for (const auto& tx : transactions) {
-            hashes.push_back(tx.getHash());
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t length = sizeof(addr);
+        bool ok = ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+                  ::listen(listener, 1) == 0 &&
+                  ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &length) == 0;
+        if (ok) {
+            a = ::socket(AF_INET, SOCK_STREAM, 0);
+            ok = a >= 0 && ::connect(a, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        }
+        if (ok) {
+            b = ::accept(listener, nullptr, nullptr);
+            ok = b >= 0;
+        }
+        ::close(listener);
+        if (!ok) {
+            if (a >= 0) ::close(a);
+            if (b >= 0) ::close(b);
+            a = b = -1;
+            return false;
         }
         
-        root = buildTree(hashes);
+        int one = 1;
+        ::setsockopt(a, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        ::setsockopt(b, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return true;
     }
-    
-    std::string getRoot() const { return root; }
 };
 
+// Relie deux nœuds dans les deux sens (avant leur démarrage)
+void connectInMemory(NetworkNode& a, NetworkNode& b) {
+    size_t indexAtA = a.peerCount();
+    size_t indexAtB = b.peerCount();
+    a.addPeer(std::unique_ptr<PeerLink>(new MemoryLink(b, indexAtB)));
+    b.addPeer(std::unique_ptr<PeerLink>(new MemoryLink(a, indexAtA)));
+}
+
+bool connectOverTcp(NetworkNode& a, NetworkNode& b) {
+    int fdA, fdB;
+    if (!TcpLink::openLoopbackPair(fdA, fdB)) return false;
+    size_t indexAtA = a.peerCount();
+    size_t indexAtB = b.peerCount();
+    a.addPeer(std::unique_ptr<PeerLink>(new TcpLink(fdA, a, indexAtA)));
+    b.addPeer(std::unique_ptr<PeerLink>(new TcpLink(fdB, b, indexAtB)));
+    return true;
+}
+
 // ============================================================================
-// PARTIE 2: Validateurs pour Proof of Stake
+// PARTIE 5: Analyse comparative
 // ============================================================================
 
-class Validator {
-private:
-    std::string address;
-    double stake;
-    int blocksValidated;
+// Coût du tirage d'un validateur selon la structure utilisée
+void benchmarkValidatorSelection(size_t validatorCount = 50000, size_t draws = 100000) {
+    std::cout << "\n🎲 Tirage pondéré parmi " << validatorCount << " validateurs:" << std::endl;
     
-public:
-    Validator(const std::string& addr, double stk) 
-        : address(addr), stake(stk), blocksValidated(0) {}
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> weights(validatorCount);
+    StakeSampler fenwick;
+    for (size_t i = 0; i < validatorCount; i++) {
+        weights[i] = StakeSampler::weightOf(static_cast<double>(100 + rng() % 10000));
+        fenwick.add(weights[i]);
+    }
+    AliasTable aliasTable(weights);
     
-    std::string getAddress() const { return address; }
-    double getStake() const { return stake; }
-    int getBlocksValidated() const { return blocksValidated; }
+    auto timeDraws = [&](const std::string& label, size_t count, const std::function<size_t()>& draw) {
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t checksum = 0;
+        for (size_t d = 0; d < count; d++) checksum += draw();
+        auto end = std::chrono::high_resolution_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / count;
+        std::cout << "   " << std::setw(26) << std::left << label << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(10) << ns << " ns/tirage"
+                  << "  (somme de contrôle " << checksum % 1000 << ")" << std::endl;
+    };
     
-    void incrementBlocksValidated() { blocksValidated++; }
+    // Ancienne méthode: somme des stakes puis parcours cumulatif à chaque bloc
+    // (échantillon réduit, sinon la démonstration dure plusieurs secondes)
+    timeDraws("Parcours linéaire O(n)", std::max<size_t>(draws / 100, 1), [&] {
+        uint64_t total = 0;
+        for (uint64_t w : weights) total += w;
+        uint64_t target = std::uniform_int_distribution<uint64_t>(0, total - 1)(rng);
+        for (size_t i = 0; i < weights.size(); i++) {
+            if (target < weights[i]) return i;
+            target -= weights[i];
+        }
+        return weights.size() - 1;
+    });
+    timeDraws("Arbre de Fenwick O(log n)", draws, [&] { return fenwick.sample(rng); });
+    timeDraws("Table d'alias O(1)", draws, [&] { return aliasTable.sample(rng); });
     
-    void display() const {
-        std::cout << "  👤 " << std::setw(15) << std::left << address 
-                  << " | Stake: " << std::setw(8) << std::right << std::fixed 
-                  << std::setprecision(2) << stake 
-                  << " | Blocs validés: " << blocksValidated << std::endl;
+    // Mise à jour des stakes: O(log n) pour Fenwick, reconstruction pour l'alias
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t u = 0; u < 1000; u++) {
+        fenwick.update(rng() % validatorCount, StakeSampler::weightOf(static_cast<double>(100 + rng() % 10000)));
     }
-};
-
-// ============================================================================
-// PARTIE 3: Classe Block (avec PoW et PoS)
-// ============================================================================
-
-class Block {
-private:
-    int index;
-    std::string timestamp;
-    std::vector<Transaction> transactions;
-    std::string previousHash;
-    std::string merkleRoot;
-    int nonce;
-    std::string hash;
-    std::string consensusType;  // "PoW" ou "PoS"
-    std::string validator;      // Pour PoS uniquement
-    int difficulty;
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "   1000 mises à jour de stake (Fenwick): "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " µs" << std::endl;
     
-    std::string getCurrentTimestamp() {
-        auto now = std::chrono::system_clock::now();
-        std::time_t now_time = std::chrono::system_clock::to_time_t(now);
-        std::stringstream ss;
-        ss << std::ctime(&now_time);
-        std::string ts = ss.str();
-        if (!ts.empty() && ts.back() == '\n') ts.pop_back();
-        return ts;
-    }
+    // Contrôle de la distribution sur trois validateurs (stakes 1000/500/1500)
+    StakeSampler small;
+    small.add(StakeSampler::weightOf(1000));
+    small.add(StakeSampler::weightOf(500));
+    small.add(StakeSampler::weightOf(1500));
+    std::array<size_t, 3> counts = {};
+    for (size_t d = 0; d < 60000; d++) counts[small.sample(rng)]++;
+    std::cout << "   Fréquences observées (attendu 33.3% / 16.7% / 50.0%): " << std::setprecision(1)
+              << 100.0 * counts[0] / 60000 << "% / " << 100.0 * counts[1] / 60000 << "% / "
+              << 100.0 * counts[2] / 60000 << "%" << std::endl;
+}
+
+// Réseau simulé de validatorCount validateurs: inscription, production de
+// blocs PoS sur plusieurs époques, mises à jour de stake en masse,
+// répartition de récompenses et revérification de la chaîne
+void benchmarkValidatorRegistry(size_t validatorCount = 1000000) {
+    using Clock = std::chrono::high_resolution_clock;
+    auto ms = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
     
-    std::string calculateHash() const {
-        std::stringstream ss;
-        ss << index << timestamp << previousHash << merkleRoot << nonce;
-        if (consensusType == "PoS") {
-            ss << validator;
-        }
-        return SHA256::hash(ss.str());
+    std::cout << "\n🏛️  Registre de " << validatorCount << " validateurs:" << std::endl;
+    Blockchain network(1);
+    std::mt19937_64 rng(7);
+    // Comptes synthétiques: dériver un million de paires de clés mesurerait
+    // Ed25519, pas le registre
+    std::vector<std::string> names(validatorCount);
+    std::vector<Address> addresses(validatorCount);
+    for (size_t i = 0; i < validatorCount; i++) {
+        names[i] = "V" + std::to_string(i);
+        addresses[i] = Address::fromName(names[i].c_str());
     }
     
-public:
-    Block(int idx, const std::vector<Transaction>& txs, const std::string& prevHash)
-        : index(idx), transactions(txs), previousHash(prevHash), 
-          nonce(0), consensusType(""), difficulty(0) {
-        timestamp = getCurrentTimestamp();
-        
-        // Calculer le Merkle Root
-        MerkleTree merkleTree;
-        merkleTree.build(transactions);
-        merkleRoot = merkleTree.getRoot();
-        
-        hash = calculateHash();
+    auto start = Clock::now();
+    network.getValidators().reserve(validatorCount);
+    for (size_t i = 0; i < validatorCount; i++) {
+        network.addValidator(addresses[i], names[i], static_cast<double>(32 + rng() % 1000));
     }
+    std::cout << std::fixed << std::setprecision(1)
+              << "   Inscription:                    " << ms(start) << " ms" << std::endl;
     
-    // PROOF OF WORK
-    long long mineBlock(int diff) {
-        difficulty = diff;
-        consensusType = "PoW";
-        
-        auto start = std::chrono::high_resolution_clock::now();
-        
-        std::string target(difficulty, '0');
-        nonce = 0;
-        hash = calculateHash();
-        
-        while (hash.substr(0, difficulty) != target) {
-            nonce++;
-            hash = calculateHash();
+    // Blocs PoS sur deux époques complètes (ajout silencieux)
+    uint32_t epochLength = network.getEpochLength();
+    auto produce = [&](uint32_t blocks) {
+        for (uint32_t b = 0; b < blocks; b++) {
+            std::vector<SignedTransaction> txs = {SignedTransaction(900000 + network.getSize(), "Reward", "Pool", COIN)};
+            network.appendPrepared(txs, Block::computeMerkleRoot(txs), false);
         }
-        
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    }
+    };
+    start = Clock::now();
+    produce(2 * epochLength);
+    std::cout << "   " << 2 * epochLength << " blocs PoS (2 époques):      " << ms(start) << " ms" << std::endl;
     
-    // PROOF OF STAKE
-    long long validateBlock(const std::string& val) {
-        consensusType = "PoS";
-        validator = val;
-        
-        auto start = std::chrono::high_resolution_clock::now();
-        
-        // Simulation de validation (vérification des transactions)
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        
-        hash = calculateHash();
-        
-        auto end = std::chrono::high_resolution_clock::now();
-        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    // 10% des stakes changent: appliqués en bloc à la prochaine frontière
+    start = Clock::now();
+    for (size_t u = 0; u < validatorCount / 10; u++) {
+        network.updateValidatorStake(addresses[rng() % validatorCount], static_cast<double>(32 + rng() % 1000));
     }
+    double queued = ms(start);
+    start = Clock::now();
+    produce(epochLength - network.getSize() % epochLength);
+    std::cout << "   " << validatorCount / 10 << " changements de stake:   " << queued
+              << " ms en file, " << ms(start) << " ms jusqu'à la frontière incluse" << std::endl;
     
-    // Vérification de la validité du bloc
-    bool isValid() const {
-        if (hash != calculateHash()) return false;
-        
-        if (consensusType == "PoW") {
-            std::string target(difficulty, '0');
-            return hash.substr(0, difficulty) == target;
-        }
-        
-        return true;
+    start = Clock::now();
+    Amount distributed = network.getValidators().distributeRewards(1000000 * COIN);
+    std::cout << "   Répartition de récompenses:     " << ms(start) << " ms ("
+              << formatAmount(distributed) << " coins distribués)" << std::endl;
+    
+    start = Clock::now();
+    bool valid = network.isChainValid(true);
+    std::cout << "   Revérification de la chaîne:    " << ms(start) << " ms ("
+              << (valid ? "valide ✓" : "INVALIDE ✗") << ")" << std::endl;
+}
+
+// Complète text par des espaces jusqu'à width caractères affichés (et non
+// octets: é, µ, ± et × en occupent deux en UTF-8), aligné à gauche ou à droite
+std::string padDisplay(const std::string& text, size_t width, bool alignRight = false) {
+    size_t shown = 0;
+    for (unsigned char c : text) shown += ((c & 0xc0) != 0x80) ? 1 : 0;
+    std::string fill(width > shown ? width - shown : 0, ' ');
+    return alignRight ? fill + text : text + fill;
+}
+
+// Résumé d'un échantillon de mesures: moyenne et demi-largeur de son
+// intervalle de confiance à 95 % (loi de Student), médiane et 99e centile
+struct SampleStats {
+    size_t count = 0;
+    double mean = 0;
+    double stddev = 0;
+    double ci95 = 0;
+    double median = 0;
+    double p99 = 0;
+    
+    // Quantile à 97,5 % de la loi de Student à df degrés de liberté
+    static double studentT975(size_t df) {
+        static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                       2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        if (df == 0) return 0;
+        if (df <= 30) return table[df - 1];
+        if (df <= 60) return 2.000;
+        if (df <= 120) return 1.980;
+        return 1.960;
     }
     
-    // Affichage
-    void display() const {
-        std::cout << "╔════════════════════════════════════════════════════════════╗" << std::endl;
-        std::cout << "║ BLOC #" << std::setw(51) << std::left << index << "║" << std::endl;
-        std::cout << "╠════════════════════════════════════════════════════════════╣" << std::endl;
-        std::cout << "║ Consensus: " << std::setw(47) << std::left << consensusType << "║" << std::endl;
-        std::cout << "║ Timestamp: " << std::setw(47) << std::left << timestamp.substr(0, 47) << "║" << std::endl;
-        std::cout << "║ Transactions: " << std::setw(44) << std::left << transactions.size() << "║" << std::endl;
-        
-        for (size_t i = 0; i < transactions.size() && i < 3; i++) {
-            std::string txStr = transactions[i].getId() + ": " + 
-                               transactions[i].getSender() + "→" + 
-                               transactions[i].getReceiver();
-            std::cout << "║   • " << std::setw(53) << std::left << txStr.substr(0, 53) << "║" << std::endl;
-        }
+    static SampleStats of(std::vector<double> samples) {
+        SampleStats st;
+        st.count = samples.size();
+        if (samples.empty()) return st;
         
-        std::cout << "║ Merkle Root: " << std::setw(45) << std::left << merkleRoot.substr(0, 45) << "║" << std::endl;
-        
-        if (consensusType == "PoW") {
-            std::cout << "║ Nonce: " << std::setw(51) << std::left << nonce << "║" << std::endl;
-            std::cout << "║ Difficulté: " << std::setw(46) << std::left << difficulty << "║" << std::endl;
-        } else if (consensusType == "PoS") {
-            std::cout << "║ Validateur: " << std::setw(46) << std::left << validator << "║" << std::endl;
+        double sum = 0;
+        for (double x : samples) sum += x;
+        st.mean = sum / samples.size();
+        double squares = 0;
+        for (double x : samples) squares += (x - st.mean) * (x - st.mean);
+        if (samples.size() > 1) {
+            st.stddev = std::sqrt(squares / (samples.size() - 1));
+            st.ci95 = studentT975(samples.size() - 1) * st.stddev / std::sqrt(static_cast<double>(samples.size()));
         }
         
-        std::cout << "║ Hash précédent: " << std::setw(42) << std::left << previousHash.substr(0, 42) << "║" << std::endl;
-        std::cout << "║ Hash: " << std::setw(52) << std::left << hash.substr(0, 52) << "║" << std::endl;
-        std::cout << "╚════════════════════════════════════════════════════════════╝" << std::endl;
+        std::sort(samples.begin(), samples.end());
+        size_t mid = samples.size() / 2;
+        st.median = (samples.size() % 2 == 1) ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2;
+        // 99e centile au rang le plus proche
+        size_t rank = static_cast<size_t>(std::ceil(0.99 * samples.size()));
+        st.p99 = samples[std::max<size_t>(rank, 1) - 1];
+        return st;
     }
-    
-    // Getters
-    int getIndex() const { return index; }
-    std::string getHash() const { return hash; }
-    std::string getPreviousHash() const { return previousHash; }
-    std::string getConsensusType() const { return consensusType; }
-    std::string getValidator() const { return validator; }
 };
 
-// ============================================================================
-// PARTIE 4: Classe Blockchain
-// ============================================================================
+// Durée lisible à partir de nanosecondes
+std::string formatNanos(double ns) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(ns < 1e4 ? 2 : 1);
+    if (ns >= 1e9) out << ns / 1e9 << " s";
+    else if (ns >= 1e6) out << ns / 1e6 << " ms";
+    else if (ns >= 1e3) out << ns / 1e3 << " µs";
+    else out << ns << " ns";
+    return out.str();
+}
 
-class Blockchain {
-private:
-    std::vector<Block*> chain;
-    std::vector<Validator> validators;
-    int powDifficulty;
+// Coût du minage selon la difficulté. La recherche du nonce suit une loi
+// géométrique (écart-type ≈ moyenne): un seul bloc par difficulté ne dit
+// presque rien, on mine donc de nombreux blocs indépendants, hors de toute
+// chaîne et sans affichage pendant la mesure. Le nombre d'essais est borné
+// par hashBudget hachages attendus par difficulté (au moins minTrials).
+void benchmarkMining(const std::vector<int>& difficulties = {1, 2, 3, 4, 5}, double hashBudget = 4e6,
+                     size_t minTrials = 10, size_t maxTrials = 500) {
+    using Clock = std::chrono::steady_clock;
     
-    // Sélectionne un validateur basé sur le stake (weighted random)
-    Validator* selectValidator() {
-        if (validators.empty()) return nullptr;
-        
-        double totalStake = 0;
-        for (const auto& v : validators) {
-            totalStake += v.getStake();
-        }
-        
-        double random = (static_cast<double>(rand()) / RAND_MAX) * totalStake;
-        double cumulative = 0;
+    struct Row {
+        int difficulty;
+        double expectedAttempts;
+        SampleStats nanos;
+        SampleStats attempts;
+        double hashrate;
+    };
+    std::vector<Row> rows;
+    Arena arena;
+    
+    for (int difficulty : difficulties) {
+        uint32_t bits = Target::fromZeroNibbles(difficulty);
+        double expected = static_cast<double>(Target::work(bits));
+        size_t trials = static_cast<size_t>(std::clamp(hashBudget / expected, double(minTrials), double(maxTrials)));
         
-        for (auto& v : validators) {
-            cumulative += v.getStake();
-            if (random <= cumulative) {
-                return &v;
-            }
+        std::vector<double> nanos, attempts;
+        double totalNanos = 0, totalAttempts = 0;
+        for (size_t t = 0; t < trials; t++) {
+            // Contenu différent à chaque essai: des recherches indépendantes
+            Arena::Marker marker = arena.mark();
+            std::vector<SignedTransaction> txs = {
+                SignedTransaction(static_cast<uint32_t>(100000 + t), "Coinbase", "Mineur", COIN)};
+            Block* block = Block::create(arena, 1, txs, GENESIS_HASH);
+            
+            auto start = Clock::now();
+            uint64_t hashes = 0;
+            block->mineBlock(bits, &hashes);
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            
+            double tries = double(hashes);
+            nanos.push_back(ns);
+            attempts.push_back(tries);
+            totalNanos += ns;
+            totalAttempts += tries;
+            arena.release(marker);
         }
-        
-        return &validators[0];
+        rows.push_back({difficulty, expected, SampleStats::of(nanos), SampleStats::of(attempts),
+                        totalAttempts * 1e9 / std::max(totalNanos, 1.0)});
     }
     
-public:
-    Blockchain(int difficulty = 3) : powDifficulty(difficulty) {
-        // Créer le bloc Genesis
-        std::vector<Transaction> genesisTxs;
-        genesisTxs.push_back(Transaction("TX0", "Genesis", "System", 0));
-        
-        Block* genesis = new Block(0, genesisTxs, "0");
-        genesis->validateBlock("Genesis");
-        chain.push_back(genesis);
-        
-        std::cout << "✅ Blockchain initialisée avec le bloc Genesis" << std::endl;
+    std::cout << "\n⛏️  Minage de n blocs indépendants par difficulté (moyenne ± IC 95 %):" << std::endl;
+    std::cout << "  " << padDisplay("d", 4) << padDisplay("n", 6) << padDisplay("essais / 16^d", 16)
+              << padDisplay("H/s", 10) << padDisplay("temps moyen", 24) << padDisplay("médiane", 12)
+              << padDisplay("p99", 12) << "16^d / (H/s)" << std::endl;
+    for (const Row& r : rows) {
+        std::ostringstream ratio, rate;
+        ratio << std::fixed << std::setprecision(2) << r.attempts.mean / r.expectedAttempts << " ± "
+              << r.attempts.ci95 / r.expectedAttempts;
+        rate << std::fixed << std::setprecision(0) << r.hashrate;
+        std::cout << "  " << padDisplay(std::to_string(r.difficulty), 4) << padDisplay(std::to_string(r.nanos.count), 6)
+                  << padDisplay(ratio.str(), 16) << padDisplay(rate.str(), 10)
+                  << padDisplay(formatNanos(r.nanos.mean) + " ± " + formatNanos(r.nanos.ci95), 24)
+                  << padDisplay(formatNanos(r.nanos.median), 12) << padDisplay(formatNanos(r.nanos.p99), 12)
+                  << formatNanos(r.expectedAttempts / r.hashrate * 1e9) << std::endl;
     }
+    std::cout << "  💡 essais / 16^d ≈ 1: chaque zéro hexadécimal exigé divise par 16 la probabilité"
+              << " de succès, le temps attendu est 16^d / hashrate" << std::endl;
+}
+
+// Propagation dans un réseau de nœuds (PARTIE 4.2): un anneau plus une corde
+// vers le nœud opposé, reliés en mémoire ou par TCP local. Pour chaque
+// taille n, le nœud 0 mine un bloc de financement (une émission vers
+// "Payeur"); n dépenses signées en chaîne (chacune dépense la monnaie
+// rendue par la précédente) sont ensuite soumises au nœud opposé, relayées
+// de proche en proche, puis minées par le nœud 0 dans un second bloc. Son
+// coût de validation croît avec n (une signature Ed25519 par transaction),
+// et chaque nœud ne relaie un bloc qu'une fois validé. Délais mesurés depuis
+// le scellement jusqu'à la validation sur chaque nœud.
+void simulateNetwork(bool overTcp, size_t nodeCount = 8, const std::vector<size_t>& blockSizes = {10, 100, 400}) {
+    nodeCount = std::max<size_t>(nodeCount, 4);
+    PropagationLog log;
+    std::vector<std::unique_ptr<NetworkNode>> nodes;
+    for (size_t i = 0; i < nodeCount; i++) nodes.emplace_back(new NetworkNode(i, log));
     
-    ~Blockchain() {
-        for (auto block : chain) {
-            delete block;
-        }
-    }
+    bool linked = true;
+    size_t links = 0;
+    auto connect = [&](size_t a, size_t b) {
+        if (overTcp) linked = linked && connectOverTcp(*nodes[a], *nodes[b]);
+        else connectInMemory(*nodes[a], *nodes[b]);
+        links++;
+    };
+    for (size_t i = 0; i < nodeCount; i++) connect(i, (i + 1) % nodeCount);
+    for (size_t i = 0; i < nodeCount / 2; i++) connect(i, i + nodeCount / 2);
     
-    // Ajouter un validateur
-    void addValidator(const std::string& address, double stake) {
-        validators.push_back(Validator(address, stake));
+    std::cout << "\n🌐 " << nodeCount << " nœuds, " << links << " liens (anneau + cordes), "
+              << (overTcp ? "TCP sur 127.0.0.1" : "canaux en mémoire") << std::endl;
+    if (!linked) {
+        std::cout << "❌ Connexions TCP locales impossibles dans cet environnement" << std::endl;
+        for (auto& node : nodes) node->stop();
+        return;
     }
+    for (auto& node : nodes) node->start();
     
-    // Ajouter un bloc avec Proof of Work
-    long long addBlockPoW(const std::vector<Transaction>& transactions) {
-        std::string previousHash = chain.back()->getHash();
-        int index = chain.size();
-        
-        Block* newBlock = new Block(index, transactions, previousHash);
-        
-        std::cout << "🔨 Mining bloc #" << index << " (PoW, difficulté " 
-                  << powDifficulty << ")..." << std::endl;
-        
-        long long miningTime = newBlock->mineBlock(powDifficulty);
-        chain.push_back(newBlock);
+    struct Row {
+        std::string label;
+        size_t txs;
+        PropagationLog::Record record;
+        bool complete;
+    };
+    std::vector<Row> rows;
+    std::vector<double> txMicros;
+    uint64_t txWireBytes = 0;
+    size_t txCount = 0;
+    bool allComplete = true;
+    
+    const auto timeout = std::chrono::seconds(30);
+    NetworkNode& miner = *nodes[0];
+    NetworkNode& relay = *nodes[nodeCount / 2];
+    uint32_t nextId = 700000;
+    
+    for (size_t requested : blockSizes) {
+        // Chaque dépense coûte 2 unités (montant et frais): l'émission les couvre toutes
+        size_t size = std::max<size_t>(1, std::min<size_t>(requested, BLOCK_SUBSIDY / 2));
+        std::vector<SignedTransaction> funding = {
+            SignedTransaction(nextId++, "Coinbase", "Payeur", static_cast<Amount>(2 * size))};
+        SHA256::Digest hash;
+        if (!miner.mine(funding, hash)) break;
+        bool complete = log.waitUntil(hash, nodeCount, timeout);
+        rows.push_back({"financement", 1, log.get(hash), complete});
+        allComplete = allComplete && complete;
         
-        std::cout << "✅ Bloc miné en " << miningTime / 1000.0 << " ms" << std::endl;
+        std::vector<SignedTransaction> spends;
+        OutPoint input = funding[0].outPoint(0);
+        for (size_t k = 0; k < size; k++) {
+            spends.push_back(SignedTransaction(nextId++, "Payeur", "Receveur", 1, 1, input));
+            input = spends.back().outPoint(1);
+        }
+        for (const SignedTransaction& tx : spends) relay.submit(tx);
+        for (const Transaction& tx : spends) {
+            complete = log.waitUntil(tx.getDigest(), nodeCount, timeout);
+            allComplete = allComplete && complete;
+            PropagationLog::Record record = log.get(tx.getDigest());
+            txMicros.push_back(static_cast<double>(*std::max_element(record.arrivals.begin(), record.arrivals.end())));
+            txWireBytes += record.wireBytes;
+            txCount++;
+        }
         
-        return miningTime;
+        if (!miner.mine(spends, hash)) break;
+        complete = log.waitUntil(hash, nodeCount, timeout);
+        rows.push_back({"dépenses signées", size, log.get(hash), complete});
+        allComplete = allComplete && complete;
     }
     
-    // Ajouter un bloc avec Proof of Stake
-    long long addBlockPoS(const std::vector<Transaction>& transactions) {
-        if (validators.empty()) {
-            std::cout << "❌ Aucun validateur disponible!" << std::endl;
-            return 0;
-        }
-        
-        Validator* selected = selectValidator();
-        
-        std::string previousHash = chain.back()->getHash();
-        int index = chain.size();
-        
-        Block* newBlock = new Block(index, transactions, previousHash);
-        
-        std::cout << "💎 Validation bloc #" << index << " (PoS) par " 
-                  << selected->getAddress() << "..." << std::endl;
-        
-        long long validationTime = newBlock->validateBlock(selected->getAddress());
-        chain.push_back(newBlock);
-        selected->incrementBlocksValidated();
-        
-        std::cout << "✅ Bloc validé en " << validationTime / 1000.0 << " ms" << std::endl;
-        
-        return validationTime;
+    auto us = [](double micros) { return formatNanos(micros * 1000); };
+    
+    std::cout << "  " << padDisplay("Bloc", 18) << padDisplay("tx", 6) << padDisplay("taille", 10)
+              << padDisplay("octets réseau", 15) << padDisplay("délai méd.", 12) << padDisplay("dernier nœud", 14) << "validation moy." << std::endl;
+    for (const Row& r : rows) {
+        // Le nœud d'origine (délai nul) n'entre pas dans les statistiques
+        std::vector<double> arrivals(r.record.arrivals.begin() + 1, r.record.arrivals.end());
+        std::vector<double> validations(r.record.validations.begin(), r.record.validations.end());
+        SampleStats delay = SampleStats::of(arrivals);
+        double last = arrivals.empty() ? 0 : *std::max_element(arrivals.begin(), arrivals.end());
+        size_t bytes = BlockHeader::SERIALIZED_SIZE + 4 + r.txs * Transaction::SERIALIZED_SIZE;
+        std::cout << "  " << padDisplay(r.label, 18) << padDisplay(std::to_string(r.txs), 6)
+                  << padDisplay(std::to_string(bytes), 10)
+                  << padDisplay(std::to_string(r.record.wireBytes), 15) << padDisplay(us(delay.median), 12)
+                  << padDisplay(r.complete ? us(last) : "incomplet", 14) << us(SampleStats::of(validations).mean)
+                  << std::endl;
     }
     
-    // Vérifier l'intégrité de la chaîne
-    bool isChainValid() const {
-        for (size_t i = 1; i < chain.size(); i++) {
-            const Block* currentBlock = chain[i];
-            const Block* previousBlock = chain[i - 1];
-            
-            // Vérifier le hash du bloc actuel
-            if (!currentBlock->isValid()) {
-                std::cout << "❌ Bloc #" << currentBlock->getIndex() 
-                          << " invalide!" << std::endl;
-                return false;
-            }
-            
-            // Vérifier le lien avec le bloc précédent
-            if (currentBlock->getPreviousHash() != previousBlock->getHash()) {
-                std::cout << "❌ Chaîne brisée au bloc #" 
-                          << currentBlock->getIndex() << "!" << std::endl;
-                return false;
-            }
-        }
-        return true;
+    SampleStats txDelay = SampleStats::of(txMicros);
+    std::cout << "  " << txCount << " transactions relayées: tous les nœuds atteints en " << us(txDelay.median)
+              << " (médiane), " << us(txDelay.p99) << " (p99), "
+              << (txCount ? txWireBytes / txCount : 0) << " octets réseau par transaction" << std::endl;
+    
+    uint64_t totalBytes = 0, totalMessages = 0;
+    for (auto& node : nodes) {
+        NetworkNode::Traffic traffic = node->getTraffic();
+        totalBytes += traffic.bytesSent;
+        totalMessages += traffic.messagesSent;
     }
+    std::string tip = miner.getTipHash();
+    bool agreed = true;
+    for (auto& node : nodes) agreed = agreed && node->getTipHash() == tip;
+    for (auto& node : nodes) node->stop();
     
-    // Afficher la blockchain
-    void display() const {
-        std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
-        std::cout << "║              BLOCKCHAIN - " << chain.size() << " BLOCS" 
-                  << std::string(27 - std::to_string(chain.size()).length(), ' ') << "║" << std::endl;
-        std::cout << "╚══════════════════════════════════════════════════════════════╝\n" << std::endl;
+    std::cout << "  Trafic total: " << totalMessages << " messages, " << totalBytes << " octets" << std::endl;
+    std::cout << "  " << (agreed && allComplete ? "✅ Tous les nœuds ont la même tête: " : "❌ Nœuds en désaccord, tête du nœud 0: ")
+              << tip.substr(0, 16) << "..." << std::endl;
+}
+
+// Réajustement de la cible face à un hashrate variable. Rien n'est miné: le
+// temps de chaque bloc suit une loi exponentielle de moyenne
+// travail(cible) / hashrate, et la cible du bloc suivant est calculée par la
+// même règle que celle des Blockchain. Pour chaque phase, temps de bloc moyen
+// sur toute la phase, puis sur sa seconde moitié (régime établi).
+void simulateDifficultyRetargeting(uint32_t blocksPerPhase = 400) {
+    struct Phase {
+        const char* label;
+        double hashrateFactor;   // par rapport au hashrate qui tient la cible initiale
+        bool oscillating;        // facteur tiré entre ×1 et ×3 à chaque bloc
+    };
+    const std::vector<Phase> phases = {
+        {"stable ×1", 1.0, false},
+        {"flotte ×4", 4.0, false},
+        {"flotte ×0.25", 0.25, false},
+        {"oscille ×1..×3", 1.0, true},
+    };
+    
+    const uint32_t spacing = 600;
+    const uint32_t initialBits = Target::fromZeroNibbles(8);
+    const double baseHashrate = static_cast<double>(Target::work(initialBits)) / spacing;
+    const std::vector<DifficultyRetarget> rules = {
+        DifficultyRetarget(initialBits, DifficultyRetarget::FIXED, spacing),
+        DifficultyRetarget(initialBits, DifficultyRetarget::WINDOW, spacing, 20),
+        DifficultyRetarget(initialBits, DifficultyRetarget::EXPONENTIAL, spacing, 20),
+    };
+    
+    // results[règle][phase] = {moyenne, moyenne de la seconde moitié}
+    std::vector<std::vector<std::pair<double, double>>> results;
+    for (const DifficultyRetarget& rule : rules) {
+        std::mt19937_64 rng(2024);
+        std::vector<BlockHeader> headers;
+        double clock = GENESIS_HEADER.timestamp;
+        auto ancestor = [&headers](uint32_t k) -> const BlockHeader* {
+            return k < headers.size() ? &headers[headers.size() - 1 - k] : nullptr;
+        };
         
-        for (const auto& block : chain) {
-            block->display();
-            std::cout << std::endl;
+        results.emplace_back();
+        for (const Phase& phase : phases) {
+            double total = 0, settled = 0;
+            for (uint32_t b = 0; b < blocksPerPhase; b++) {
+                BlockHeader header;
+                header.index = static_cast<uint32_t>(headers.size() + 1);
+                header.consensus = BlockHeader::POW;
+                header.bits = rule.nextBits(header.index, ancestor);
+                
+                double factor = phase.oscillating
+                    ? std::uniform_real_distribution<double>(1.0, 3.0)(rng) : phase.hashrateFactor;
+                double mean = static_cast<double>(Target::work(header.bits)) / (baseHashrate * factor);
+                double blockTime = std::exponential_distribution<double>(1.0 / mean)(rng);
+                clock += blockTime;
+                header.timestamp = static_cast<uint32_t>(clock);
+                headers.push_back(header);
+                
+                total += blockTime;
+                if (b >= blocksPerPhase / 2) settled += blockTime;
+            }
+            results.back().push_back({total / blocksPerPhase, settled / (blocksPerPhase - blocksPerPhase / 2)});
         }
     }
     
-    // Afficher les validateurs
-    void displayValidators() const {
-        std::cout << "\n👥 VALIDATEURS (" << validators.size() << "):\n" << std::endl;
-        for (const auto& v : validators) {
-            v.display();
-        }
-    }
+    std::cout << "\n🎯 Réajustement de la cible (" << spacing << " s visées, " << blocksPerPhase
+              << " blocs par phase, temps moyen en s: phase entière / seconde moitié):\n" << std::endl;
     
-    // Statistiques
-    void displayStats() const {
-        int powBlocks = 0;
-        int posBlocks = 0;
-        
-        for (const auto& block : chain) {
-            if (block->getConsensusType() == "PoW") powBlocks++;
-            else if (block->getConsensusType() == "PoS") posBlocks++;
+    std::cout << "  " << padDisplay("Hashrate", 16);
+    for (const DifficultyRetarget& rule : rules) std::cout << padDisplay(rule.describe(), 36);
+    std::cout << std::endl;
+    
+    for (size_t p = 0; p < phases.size(); p++) {
+        std::cout << "  " << padDisplay(phases[p].label, 16);
+        for (size_t r = 0; r < rules.size(); r++) {
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(0) << results[r][p].first << " / " << results[r][p].second;
+            std::cout << padDisplay(cell.str(), 36);
         }
-        
-        std::cout << "\n📊 STATISTIQUES DE LA BLOCKCHAIN:" << std::endl;
-        std::cout << "  Total blocs: " << chain.size() << std::endl;
-        std::cout << "  Blocs PoW: " << powBlocks << std::endl;
-        std::cout << "  Blocs PoS: " << posBlocks << std::endl;
-        std::cout << "  Validateurs: " << validators.size() << std::endl;
+        std::cout << std::endl;
     }
-    
-    int getSize() const { return chain.size(); }
-    void setDifficulty(int diff) { powDifficulty = diff; }
-};
-
-// ============================================================================
-// PARTIE 5: Analyse comparative
-// ============================================================================
+}
 
 void comparativeAnalysis() {
     std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
     std::cout << "║              ANALYSE COMPARATIVE PoW vs PoS                  ║" << std::endl;
     std::cout << "╚══════════════════════════════════════════════════════════════╝\n" << std::endl;
     
-    srand(time(nullptr));
-    
     const int NUM_BLOCKS = 5;
+    const int SAMPLE_BLOCKS = 40;
     const int POW_DIFFICULTY = 4;
     
     // Créer une blockchain
@@ -474,55 +5801,39 @@ void comparativeAnalysis() {
     std::cout << "   PHASE 1: AJOUT DE BLOCS AVEC PROOF OF WORK" << std::endl;
     std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n" << std::endl;
     
-    std::vector<long long> powTimes;
-    auto powStartTotal = std::chrono::high_resolution_clock::now();
-    
     for (int i = 1; i <= NUM_BLOCKS; i++) {
-        std::vector<Transaction> txs;
-        txs.push_back(Transaction("TX" + std::to_string(i) + "A", 
-                                  "User" + std::to_string(i), 
-                                  "User" + std::to_string(i+1), 
-                                  10.5 * i));
-        txs.push_back(Transaction("TX" + std::to_string(i) + "B", 
-                                  "User" + std::to_string(i+1), 
-                                  "User" + std::to_string(i+2), 
-                                  5.25 * i));
+        std::vector<SignedTransaction> txs;
+        txs.push_back(SignedTransaction(1000 + 2 * i, 
+                                        "User" + std::to_string(i), 
+                                        "User" + std::to_string(i+1), 
+                                        1050 * i));
+        txs.push_back(SignedTransaction(1000 + 2 * i + 1, 
+                                        "User" + std::to_string(i+1), 
+                                        "User" + std::to_string(i+2), 
+                                        525 * i, 0, txs[0].outPoint(0)));
         
-        long long time = blockchain.addBlockPoW(txs);
-        powTimes.push_back(time);
+        blockchain.addBlockPoW(txs);
     }
     
-    auto powEndTotal = std::chrono::high_resolution_clock::now();
-    long long powTotalTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-        powEndTotal - powStartTotal).count();
-    
     // ========== TEST PROOF OF STAKE ==========
     std::cout << "\n\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
     std::cout << "   PHASE 2: AJOUT DE BLOCS AVEC PROOF OF STAKE" << std::endl;
     std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n" << std::endl;
     
-    std::vector<long long> posTimes;
-    auto posStartTotal = std::chrono::high_resolution_clock::now();
-    
     for (int i = 1; i <= NUM_BLOCKS; i++) {
-        std::vector<Transaction> txs;
-        txs.push_back(Transaction("TX" + std::to_string(i+NUM_BLOCKS) + "A", 
-                                  "Validator" + std::to_string(i), 
-                                  "Validator" + std::to_string(i+1), 
-                                  15.75 * i));
-        txs.push_back(Transaction("TX" + std::to_string(i+NUM_BLOCKS) + "B", 
-                                  "Validator" + std::to_string(i+1), 
-                                  "Validator" + std::to_string(i+2), 
-                                  8.5 * i));
+        std::vector<SignedTransaction> txs;
+        txs.push_back(SignedTransaction(2000 + 2 * i, 
+                                        "Validator" + std::to_string(i), 
+                                        "Validator" + std::to_string(i+1), 
+                                        1575 * i));
+        txs.push_back(SignedTransaction(2000 + 2 * i + 1, 
+                                        "Validator" + std::to_string(i+1), 
+                                        "Validator" + std::to_string(i+2), 
+                                        850 * i, 0, txs[0].outPoint(0)));
         
-        long long time = blockchain.addBlockPoS(txs);
-        posTimes.push_back(time);
+        blockchain.addBlockPoS(txs);
     }
     
-    auto posEndTotal = std::chrono::high_resolution_clock::now();
-    long long posTotalTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-        posEndTotal - posStartTotal).count();
-    
     // ========== AFFICHAGE DE LA BLOCKCHAIN ==========
     blockchain.display();
     blockchain.displayValidators();
@@ -535,33 +5846,71 @@ void comparativeAnalysis() {
     
     if (blockchain.isChainValid()) {
         std::cout << "✅ La blockchain est VALIDE!" << std::endl;
+        std::cout << "   Point de contrôle: blocs 0.." << blockchain.getValidatedHeight()
+                  << " vérifiés (seuls les nouveaux blocs seront revérifiés)" << std::endl;
     } else {
         std::cout << "❌ La blockchain est INVALIDE!" << std::endl;
     }
     
+    // ========== MESURES ==========
+    // Quelques blocs ne suffisent pas (le minage suit une loi géométrique):
+    // SAMPLE_BLOCKS blocs par consensus sur une chaîne dédiée, ajoutés sans
+    // affichage; chaque étape est chronométrée par la Blockchain elle-même
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+    std::cout << "   PHASE 3: MESURE SUR " << SAMPLE_BLOCKS << " BLOCS PAR CONSENSUS (sans affichage)" << std::endl;
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n" << std::endl;
+    
+    Blockchain sample(POW_DIFFICULTY);
+    sample.addValidator("Alice", 1000);
+    sample.addValidator("Bob", 500);
+    sample.addValidator("Charlie", 2000);
+    sample.addValidator("David", 750);
+    
+    BlockTiming powStages, posStages;
+    std::vector<double> powTimes, posTimes;
+    for (int i = 0; i < 2 * SAMPLE_BLOCKS; i++) {
+        bool proofOfWork = i % 2 == 0;   // alternés: même état de la machine pour les deux
+        std::vector<SignedTransaction> txs = {SignedTransaction(static_cast<uint32_t>(20000 + i), "Coinbase", "Mineur", COIN)};
+        if (!sample.appendPrepared(txs, Block::computeMerkleRoot(txs), proofOfWork)) continue;
+        const BlockTiming& timing = sample.getLastBlockTiming();
+        (proofOfWork ? powStages : posStages) += timing;
+        (proofOfWork ? powTimes : posTimes).push_back(static_cast<double>(timing.total()));
+    }
+    SampleStats pow = SampleStats::of(powTimes);
+    SampleStats pos = SampleStats::of(posTimes);
+    long long powTotalTime = powStages.total();
+    long long posTotalTime = posStages.total();
+    double expectedAttempts = static_cast<double>(Target::work(Target::fromZeroNibbles(POW_DIFFICULTY)));
+    double powHashrate = powStages.attempts * 1e6 / std::max(powStages.seal, 1LL);
+    
     // ========== RÉSULTATS COMPARATIFS ==========
+    auto us = [](double micros) { return formatNanos(micros * 1000); };
+    auto meanWithInterval = [&](const SampleStats& st) { return us(st.mean) + " ± " + us(st.ci95); };
+    
     std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
     std::cout << "║           RÉSULTATS DE L'ANALYSE COMPARATIVE                 ║" << std::endl;
     std::cout << "╠══════════════════════════════════════════════════════════════╣" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
     std::cout << "║  1️⃣  RAPIDITÉ D'AJOUT DES BLOCS:                            ║" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
-    std::cout << "║    PoW (Mining):                                             ║" << std::endl;
-    std::cout << "║      • Temps total: " << std::setw(42) << std::left 
-              << (std::to_string(powTotalTime) + " ms") << "║" << std::endl;
-    std::cout << "║      • Temps moyen/bloc: " << std::setw(35) << std::left 
-              << (std::to_string(powTotalTime/NUM_BLOCKS) + " ms") << "║" << std::endl;
+    std::cout << "║    " << padDisplay("PoW (Mining, difficulté " + std::to_string(POW_DIFFICULTY) + "):", 58) << "║" << std::endl;
+    std::cout << "║      • Temps moyen/bloc: " << padDisplay(meanWithInterval(pow), 36) << "║" << std::endl;
+    std::cout << "║      • Médiane / p99: " << padDisplay(us(pow.median) + " / " + us(pow.p99), 39) << "║" << std::endl;
+    std::ostringstream hashrate;
+    hashrate << std::fixed << std::setprecision(0) << powHashrate << " H/s, essais/bloc "
+             << std::setprecision(2) << powStages.attempts / std::max<double>(pow.count, 1) / expectedAttempts
+             << " × 16^" << POW_DIFFICULTY;
+    std::cout << "║      • Hashrate: " << padDisplay(hashrate.str(), 44) << "║" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
     std::cout << "║    PoS (Validation):                                         ║" << std::endl;
-    std::cout << "║      • Temps total: " << std::setw(42) << std::left 
-              << (std::to_string(posTotalTime) + " ms") << "║" << std::endl;
-    std::cout << "║      • Temps moyen/bloc: " << std::setw(35) << std::left 
-              << (std::to_string(posTotalTime/NUM_BLOCKS) + " ms") << "║" << std::endl;
+    std::cout << "║      • Temps moyen/bloc: " << padDisplay(meanWithInterval(pos), 36) << "║" << std::endl;
+    std::cout << "║      • Médiane / p99: " << padDisplay(us(pos.median) + " / " + us(pos.p99), 39) << "║" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
     
-    double speedup = (posTotalTime > 0) ? static_cast<double>(powTotalTime) / posTotalTime : 0;
+    // Rapport des médianes: peu sensible aux blocs exceptionnellement longs
+    double speedup = (pos.median > 0) ? pow.median / pos.median : 0;
     std::cout << "║    ⚡ PoS est " << std::setw(47) << std::left 
-              << (std::to_string(static_cast<int>(speedup)) + "x PLUS RAPIDE") << "║" << std::endl;
+              << (std::to_string(static_cast<int>(speedup)) + "x PLUS RAPIDE (médianes)") << "║" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
     std::cout << "╠══════════════════════════════════════════════════════════════╣" << std::endl;
     std::cout << "║                                                              ║" << std::endl;
@@ -595,46 +5944,80 @@ void comparativeAnalysis() {
     std::cout << "║                                                              ║" << std::endl;
     std::cout << "╚══════════════════════════════════════════════════════════════╝" << std::endl;
     
-    // Tableau détaillé par bloc
+    // Distribution du temps par bloc (n blocs par consensus)
     std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
-    std::cout << "║        TEMPS DÉTAILLÉ PAR BLOC (en millisecondes)           ║" << std::endl;
-    std::cout << "╠═══════╦══════════════════════╦══════════════════════════════╣" << std::endl;
-    std::cout << "║ Bloc  ║  PoW (mining)        ║  PoS (validation)            ║" << std::endl;
-    std::cout << "╠═══════╬══════════════════════╬══════════════════════════════╣" << std::endl;
-    
-    for (int i = 0; i < NUM_BLOCKS; i++) {
-        std::cout << "║   " << std::setw(2) << (i+1) << "  ║  " 
-                  << std::setw(19) << std::right << std::fixed << std::setprecision(2) 
-                  << (powTimes[i]/1000.0) << " ║  "
-                  << std::setw(27) << std::right << (posTimes[i]/1000.0) << " ║" << std::endl;
-    }
-    
-    std::cout << "╠═══════╬══════════════════════╬══════════════════════════════╣" << std::endl;
-    std::cout << "║ TOTAL ║  " << std::setw(19) << std::right << powTotalTime 
-              << " ║  " << std::setw(27) << std::right << posTotalTime << " ║" << std::endl;
-    std::cout << "╚═══════╩══════════════════════╩══════════════════════════════╝" << std::endl;
+    std::cout << "║        " << padDisplay("TEMPS PAR BLOC SUR " + std::to_string(SAMPLE_BLOCKS) + " BLOCS PAR CONSENSUS", 54)
+              << "║" << std::endl;
+    std::cout << "╠══════════════════════╦══════════════════╦════════════════════╣" << std::endl;
+    std::cout << "║ Statistique          ║              PoW ║                PoS ║" << std::endl;
+    std::cout << "╠══════════════════════╬══════════════════╬════════════════════╣" << std::endl;
+    auto statRow = [&](const std::string& label, double powValue, double posValue) {
+        std::cout << "║ " << padDisplay(label, 21) << "║ " << padDisplay(us(powValue), 16, true)
+                  << " ║ " << padDisplay(us(posValue), 18, true) << " ║" << std::endl;
+    };
+    statRow("Moyenne", pow.mean, pos.mean);
+    statRow("IC 95 % (±)", pow.ci95, pos.ci95);
+    statRow("Écart-type", pow.stddev, pos.stddev);
+    statRow("Médiane", pow.median, pos.median);
+    statRow("p99", pow.p99, pos.p99);
+    std::cout << "╚══════════════════════╩══════════════════╩════════════════════╝" << std::endl;
+    
+    // Décomposition par étape: seul le scellement distingue vraiment PoW et PoS
+    std::cout << "\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║    TEMPS PAR ÉTAPE, TOTAL DES BLOCS MESURÉS (en µs)         ║" << std::endl;
+    std::cout << "╠══════════════════════╦══════════════════╦════════════════════╣" << std::endl;
+    std::cout << "║ Étape                ║              PoW ║                PoS ║" << std::endl;
+    std::cout << "╠══════════════════════╬══════════════════╬════════════════════╣" << std::endl;
+    auto stageRow = [](const std::string& label, long long pow, long long pos) {
+        std::cout << "║ " << label << std::string(21 - std::min<size_t>(21, label.size()), ' ')
+                  << "║ " << std::setw(16) << std::right << pow
+                  << " ║ " << std::setw(18) << std::right << pos << " ║" << std::endl;
+    };
+    stageRow("Signatures", powStages.signatures, posStages.signatures);
+    stageRow("UTXO / double dep.", powStages.utxo, posStages.utxo);
+    stageRow("Soldes", powStages.balances, posStages.balances);
+    stageRow("Index adresses", powStages.index, posStages.index);
+    stageRow("Merkle Root", powStages.merkle, posStages.merkle);
+    stageRow("Eligibilite", powStages.eligibility, posStages.eligibility);
+    stageRow("Scellement", powStages.seal, posStages.seal);
+    std::cout << "╠══════════════════════╬══════════════════╬════════════════════╣" << std::endl;
+    stageRow("TOTAL", powTotalTime, posTotalTime);
+    std::cout << "╚══════════════════════╩══════════════════╩════════════════════╝" << std::endl;
 }
 
 // ============================================================================
 // PARTIE 6: Programme principal
 // ============================================================================
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Import d'un fichier de transactions: --import <fichier> [tx/bloc] [difficulté]
+    if (argc >= 3 && std::string(argv[1]) == "--import") {
+        size_t blockSize = argc >= 4 ? std::strtoul(argv[3], nullptr, 10) : 100;
+        int difficulty = argc >= 5 ? std::atoi(argv[4]) : 3;
+        return runImport(argv[2], blockSize, difficulty);
+    }
+    
+    // Simulation réseau seule: --network [nœuds]
+    if (argc >= 2 && std::string(argv[1]) == "--network") {
+        size_t nodeCount = argc >= 3 ? std::strtoul(argv[2], nullptr, 10) : 8;
+        simulateNetwork(false, nodeCount);
+        simulateNetwork(true, nodeCount);
+        return 0;
+    }
+    
     std::cout << "╔══════════════════════════════════════════════════════════════╗" << std::endl;
     std::cout << "║          MINI-BLOCKCHAIN COMPLÈTE FROM SCRATCH               ║" << std::endl;
     std::cout << "║    (Merkle Tree + Proof of Work + Proof of Stake)           ║" << std::endl;
     std::cout << "╚══════════════════════════════════════════════════════════════╝" << std::endl;
     
-    srand(time(nullptr));
-    
     // ========== EXEMPLE 1: Démonstration des Transactions ==========
     std::cout << "\n\n>>> EXEMPLE 1: Création de transactions <<<\n" << std::endl;
     
-    std::vector<Transaction> transactions;
-    transactions.push_back(Transaction("TX001", "Alice", "Bob", 50.00));
-    transactions.push_back(Transaction("TX002", "Bob", "Charlie", 30.00));
-    transactions.push_back(Transaction("TX003", "Charlie", "David", 20.00));
-    transactions.push_back(Transaction("TX004", "David", "Eve", 10.00));
+    std::vector<SignedTransaction> transactions;
+    transactions.push_back(SignedTransaction(1, "Alice", "Bob", 50 * COIN));
+    transactions.push_back(SignedTransaction(2, "Bob", "Charlie", 30 * COIN));
+    transactions.push_back(SignedTransaction(3, "Charlie", "David", 20 * COIN));
+    transactions.push_back(SignedTransaction(4, "David", "Eve", 10 * COIN));
     
     std::cout << "📝 Transactions créées:\n" << std::endl;
     for (const auto& tx : transactions) {
@@ -656,19 +6039,145 @@ int main() {
     
     Blockchain blockchain1(3);
     
-    std::vector<Transaction> block1Txs;
-    block1Txs.push_back(Transaction("TX101", "Alice", "Bob", 100.0));
-    block1Txs.push_back(Transaction("TX102", "Bob", "Charlie", 50.0));
+    // Une seule émission par bloc, en tête: Bob paie Charlie avec la sortie qu'il vient de recevoir
+    std::vector<SignedTransaction> block1Txs;
+    block1Txs.push_back(SignedTransaction(101, "Alice", "Bob", 100 * COIN));
+    block1Txs.push_back(SignedTransaction(102, "Bob", "Charlie", 50 * COIN, 0, block1Txs[0].outPoint(0)));
     
     blockchain1.addBlockPoW(block1Txs);
     
-    std::vector<Transaction> block2Txs;
-    block2Txs.push_back(Transaction("TX103", "Charlie", "David", 25.0));
+    std::vector<SignedTransaction> block2Txs;
+    block2Txs.push_back(SignedTransaction(103, "Charlie", "David", 25 * COIN));
     
     blockchain1.addBlockPoW(block2Txs);
     
     blockchain1.display();
     
+    // Un nœud léger suit la même chaîne avec les en-têtes seuls
+    HeaderChain lightNode = blockchain1.buildHeaderChain();
+    std::vector<Transaction> body;
+    std::cout << "🪶 Nœud léger: " << lightNode.size() << " en-têtes, "
+              << sizeof(BlockHeader) << " octets par en-tête" << std::endl;
+    if (lightNode.fetchBody(1, body)) {
+        std::cout << "   Corps du bloc #1 récupéré à la demande: " << body.size()
+                  << " transactions (Merkle Root vérifié)" << std::endl;
+    }
+    
+    // Modèle UTXO: une dépense consomme une sortie, la double dépense est refusée
+    std::cout << "\n💰 Dépense d'une sortie puis tentative de double dépense:" << std::endl;
+    SignedTransaction mint(104, "Coinbase", "Alice", 100 * COIN);
+    blockchain1.addBlockPoW({mint});
+    SignedTransaction payment(105, "Alice", "Bob", 30 * COIN, 50, mint.outPoint(0));
+    blockchain1.addBlockPoW({payment});
+    blockchain1.addBlockPoW({SignedTransaction(106, "Alice", "Eve", 30 * COIN, 50, mint.outPoint(0))});
+    std::cout << "   Sorties non dépensées: " << blockchain1.getUtxoSet().size() << std::endl;
+    
+    // Sans la clé d'Alice, Eve ne peut pas dépenser la monnaie rendue à Alice
+    std::cout << "\n🔏 Tentative de dépense sans la clé du propriétaire:" << std::endl;
+    blockchain1.addBlockPoW({Transaction(107, Address::named("Alice"), Address::named("Eve"),
+                                         60 * COIN, 50, payment.outPoint(1))});
+    
+    // Vérification par lots: une équation par lot de 64 signatures
+    {
+        std::vector<SignedTransaction> signedTxs;
+        for (uint32_t i = 0; i < 512; i++) {
+            signedTxs.push_back(SignedTransaction(3000 + i, "Signataire" + std::to_string(i % 32), "Bob",
+                                                  COIN, 1, mint.outPoint(i)));
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        bool oneByOne = true;
+        for (const auto& tx : signedTxs) {
+            Ed25519::BatchItem item = tx.signatureItem();
+            oneByOne = oneByOne && Ed25519::verify(item.publicKey, item.message, item.length, item.signature);
+        }
+        auto mid = std::chrono::high_resolution_clock::now();
+        bool batched = SignatureBatchVerifier().verifyAll(signedTxs);
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        std::cout << "   " << signedTxs.size() << " signatures: une par une "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count() << " µs, par lots "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count() << " µs ("
+                  << ((oneByOne && batched) ? "toutes valides ✓" : "ÉCHEC ✗") << ")" << std::endl;
+    }
+    
+    // Historique d'une adresse: seuls les blocs dont le filtre de Bloom répond
+    // "peut-être" sont ouverts
+    Blockchain::HistoryQueryStats query;
+    std::vector<int> charlieBlocks = blockchain1.findBlocksInvolving(Address::named("Charlie"), &query);
+    std::cout << "\n🔎 Blocs impliquant Charlie:";
+    for (int height : charlieBlocks) std::cout << " #" << height;
+    std::cout << " (" << query.blocksOpened << "/" << query.blocksTested << " blocs ouverts, "
+              << query.falsePositives << " faux positif(s))" << std::endl;
+    int foundHeight = -1;
+    size_t foundPosition = 0;
+    if (blockchain1.findTransaction(payment.getDigest(), foundHeight, foundPosition)) {
+        std::cout << "   " << payment.getLabel() << " trouvée au bloc #" << foundHeight
+                  << ", position " << foundPosition << std::endl;
+    }
+    std::cout << "   Solde d'Alice: " << formatAmount(blockchain1.getBalance(Address::named("Alice")))
+              << ", historique:" << std::endl;
+    for (const Transaction* tx : blockchain1.getHistory(Address::named("Alice"))) {
+        tx->display();
+    }
+    
+    // Exécution optimiste: même résultat que l'exécution séquentielle, seules
+    // les transactions en conflit sont réexécutées
+    {
+        std::vector<Address> accounts;
+        for (int a = 0; a < 5000; a++) {
+            accounts.push_back(Address::fromName(("Compte" + std::to_string(a)).c_str()));
+        }
+        std::vector<Transaction> bulk;
+        for (int i = 0; i < 20000; i++) {
+            OutPoint funded = (i < 5000) ? OutPoint() : mint.outPoint(0);
+            bulk.push_back(Transaction(10000 + i, accounts[i % 5000], accounts[(i * 7 + 1) % 5000],
+                                       (1 + i % 10) * COIN, 1, funded));
+        }
+        AccountLedger sequential, optimistic;
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<uint8_t> expected = sequential.applySequential(bulk);
+        auto mid = std::chrono::high_resolution_clock::now();
+        ParallelLedgerExecutor::Result result = ParallelLedgerExecutor().execute(optimistic, bulk);
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        bool same = (expected == result.succeeded);
+        for (size_t a = 0; a < accounts.size() && same; a++) {
+            same = sequential.balanceOf(accounts[a]) == optimistic.balanceOf(accounts[a]);
+        }
+        std::cout << "\n⚡ Exécution de " << bulk.size() << " transactions sur "
+                  << ThreadPool::shared().size() << " thread(s):" << std::endl;
+        std::cout << "   Séquentielle: " << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count()
+                  << " µs, optimiste: " << std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count()
+                  << " µs (" << result.rounds << " tours, " << result.reexecutions << " réexécutions)" << std::endl;
+        std::cout << "   Résultat " << (same ? "identique ✓" : "DIFFÉRENT ✗") << std::endl;
+    }
+    
+    // Deux mineurs trouvent un bloc à la même hauteur: le premier reçu reste
+    // en tête, l'autre est gardé dans l'arbre comme branche concurrente. Dès
+    // qu'elle est prolongée, elle devient la plus lourde et seul le suffixe
+    // divergent est défait puis refait.
+    {
+        std::cout << "\n⛏️  Deux mineurs concurrents à la hauteur " << blockchain1.getSize() << ":" << std::endl;
+        std::string fork = blockchain1.getTipHash();
+        SignedTransaction rewardA(108, "Coinbase", "MineurA", 50 * COIN);
+        SignedTransaction rewardB(109, "Coinbase", "MineurB", 50 * COIN);
+        std::string blockA = blockchain1.mineBlockOn(fork, {rewardA});
+        std::string blockB = blockchain1.mineBlockOn(fork, {rewardB});
+        std::cout << "   Tête: bloc de " << (blockchain1.getTipHash() == blockA ? "MineurA" : "MineurB")
+                  << " (reçu en premier), " << blockchain1.getBlockTree().tipCount() << " pointes dans l'arbre" << std::endl;
+        
+        blockchain1.mineBlockOn(blockB, {SignedTransaction(110, "MineurB", "Alice", 20 * COIN, 50, rewardB.outPoint(0))});
+        std::cout << "   Solde de MineurA: " << formatAmount(blockchain1.getBalance(Address::named("MineurA")))
+                  << ", de MineurB: " << formatAmount(blockchain1.getBalance(Address::named("MineurB")))
+                  << ", récompense de MineurA: "
+                  << (blockchain1.getMempool().contains(rewardA.getDigest()) ? "revenue au mempool"
+                                                                            : "abandonnée avec son bloc")
+                  << std::endl;
+        std::cout << "   Chaîne " << (blockchain1.isChainValid() ? "valide ✓" : "INVALIDE ✗") << std::endl;
+        blockchain1.displayStats();
+    }
+    
     // ========== EXEMPLE 4: Blockchain avec PoS ==========
     std::cout << "\n\n>>> EXEMPLE 4: Blockchain avec Proof of Stake <<<\n" << std::endl;
     
@@ -683,49 +6192,91 @@ int main() {
     
     std::cout << std::endl;
     
-    std::vector<Transaction> block3Txs;
-    block3Txs.push_back(Transaction("TX201", "User1", "User2", 75.0));
-    block3Txs.push_back(Transaction("TX202", "User2", "User3", 40.0));
+    std::vector<SignedTransaction> block3Txs;
+    block3Txs.push_back(SignedTransaction(201, "User1", "User2", 75 * COIN));
+    block3Txs.push_back(SignedTransaction(202, "User2", "User3", 40 * COIN, 0, block3Txs[0].outPoint(0)));
     
     blockchain2.addBlockPoS(block3Txs);
     
-    std::vector<Transaction> block4Txs;
-    block4Txs.push_back(Transaction("TX203", "User3", "User4", 60.0));
+    std::vector<SignedTransaction> block4Txs;
+    block4Txs.push_back(SignedTransaction(203, "User3", "User4", 60 * COIN));
     
     blockchain2.addBlockPoS(block4Txs);
     
+    // Les transactions peuvent aussi passer par le mempool: le bloc suivant
+    // reprend les plus gros taux de frais dans la limite de sa taille, chaque
+    // parent avant la transaction qui dépense sa sortie
+    SignedTransaction pay204(204, "User4", "User5", 12 * COIN, 10, block4Txs[0].outPoint(0));
+    SignedTransaction pay205(205, "User5", "User6", 8 * COIN, 90, pay204.outPoint(0));
+    blockchain2.submitTransaction(pay204);
+    blockchain2.submitTransaction(pay205);
+    blockchain2.submitTransaction(SignedTransaction(206, "User6", "User1", 3 * COIN, 45, pay205.outPoint(0)));
+    std::cout << "\n📥 Mempool: " << blockchain2.getMempool().size() << " transactions en attente" << std::endl;
+    blockchain2.addBlockPoSFromMempool(2 * Transaction::SERIALIZED_SIZE);
+    std::cout << "📥 Mempool après le bloc: " << blockchain2.getMempool().size()
+              << " transaction(s) en attente" << std::endl;
+    
+    // Les producteurs sont fixés par époque de N blocs: un changement de stake
+    // attend la prochaine frontière, où les stakes sont figés et le calendrier
+    // de l'époque suivante calculé en arrière-plan
+    blockchain2.updateValidatorStake("Bob", 3000);
+    std::cout << "\n⏳ Stake de Bob porté à 3000: " << blockchain2.getPendingStakeChanges()
+              << " changement(s) en attente (époques de " << blockchain2.getEpochLength()
+              << " blocs: figé au bloc #" << blockchain2.getEpochLength() << ", élections à partir du bloc #"
+              << 2 * blockchain2.getEpochLength() << ")" << std::endl;
+    for (uint32_t id = 207; static_cast<uint32_t>(blockchain2.getSize()) <= blockchain2.getEpochLength(); id++) {
+        blockchain2.addBlockPoS({SignedTransaction(id, "User1", "User3", 5 * COIN)});
+    }
+    std::cout << "⏳ Changements en attente après la frontière: "
+              << blockchain2.getPendingStakeChanges() << std::endl;
+    
+    // La vérification relit le calendrier de l'époque de chaque bloc PoS
+    std::cout << "🔎 Validateurs élus revérifiés sur toute la chaîne: "
+              << (blockchain2.isChainValid(true) ? "conformes ✓" : "NON CONFORMES ✗") << std::endl;
+    
     blockchain2.display();
     blockchain2.displayValidators();
     
+    // Le tirage du validateur ne parcourt plus tous les stakes à chaque bloc
+    benchmarkValidatorSelection();
+    
+    // Le registre SoA tient un réseau d'un million de validateurs
+    benchmarkValidatorRegistry();
+    
     // ========== EXEMPLE 5: Test de différentes difficultés PoW ==========
     std::cout << "\n\n>>> EXEMPLE 5: Impact de la difficulté sur PoW <<<\n" << std::endl;
     
-    std::vector<int> difficulties = {2, 3, 4, 5};
-    std::vector<Transaction> testTxs;
-    testTxs.push_back(Transaction("TXTEST", "Test1", "Test2", 10.0));
+    // Nombreux blocs par difficulté: une seule recherche de nonce (loi
+    // géométrique) est trop bruitée pour comparer les difficultés
+    benchmarkMining();
     
-    std::cout << "╔════════════════╦═════════════════════════════════════════════╗" << std::endl;
-    std::cout << "║  Difficulté    ║  Temps de mining (ms)                       ║" << std::endl;
-    std::cout << "╠════════════════╬═════════════════════════════════════════════╣" << std::endl;
+    // La cible se réajuste seule: le rythme des blocs reste proche de
+    // l'intervalle visé quand la puissance de calcul varie
+    simulateDifficultyRetargeting();
     
-    for (int diff : difficulties) {
-        Blockchain testChain(diff);
-        auto start = std::chrono::high_resolution_clock::now();
-        testChain.addBlockPoW(testTxs);
-        auto end = std::chrono::high_resolution_clock::now();
-        long long time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        
-        std::cout << "║       " << std::setw(2) << diff << "       ║  " 
-                  << std::setw(42) << std::left << time << " ║" << std::endl;
+    // Même règle sur une vraie chaîne: blocs minés dans la même seconde, donc
+    // plus rapides que l'intervalle visé, la cible se resserre de bloc en bloc
+    Blockchain retargeted(3);
+    retargeted.setRetarget(DifficultyRetarget(Target::fromZeroNibbles(3), DifficultyRetarget::EXPONENTIAL, 1, 8));
+    uint32_t firstBits = retargeted.getNextBits();
+    for (uint32_t id = 9100; id < 9108; id++) {
+        std::vector<SignedTransaction> txs = {SignedTransaction(id, "Coinbase", "Mineur", COIN)};
+        retargeted.appendPrepared(txs, Block::computeMerkleRoot(txs), true);
     }
-    
-    std::cout << "╚════════════════╩═════════════════════════════════════════════╝" << std::endl;
-    std::cout << "\n💡 Le temps de mining augmente exponentiellement!" << std::endl;
+    std::cout << "\n⛓️  8 blocs avec réajustement par bloc: cible " << Target::toString(firstBits)
+              << " (~" << Target::work(firstBits) << " essais) → " << Target::toString(retargeted.getNextBits())
+              << " (~" << Target::work(retargeted.getNextBits()) << " essais), chaîne "
+              << (retargeted.isChainValid() ? "valide ✓" : "INVALIDE ✗") << std::endl;
     
     // ========== EXEMPLE 6: Analyse comparative complète ==========
     std::cout << "\n\n>>> EXEMPLE 6: ANALYSE COMPARATIVE COMPLÈTE PoW vs PoS <<<" << std::endl;
     comparativeAnalysis();
     
+    // ========== EXEMPLE 7: Propagation dans un réseau de nœuds ==========
+    std::cout << "\n\n>>> EXEMPLE 7: Propagation des blocs entre nœuds (mémoire puis TCP local) <<<" << std::endl;
+    simulateNetwork(false);
+    simulateNetwork(true);
+    
     // ========== CONCLUSION ==========
     std::cout << "\n\n╔══════════════════════════════════════════════════════════════╗" << std::endl;
     std::cout << "║                         CONCLUSION                           ║" << std::endl;
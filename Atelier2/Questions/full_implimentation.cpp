@@ -9,6 +9,9 @@
 #include <cmath>
 #include <algorithm>
 
+// g++ -std=c++17 -O2 full_implimentation.cpp policy_blockchain.cpp
+#include "policy_blockchain.hpp"
+
 // ==================== AUTOMATE CELLULAIRE ====================
 
 class CellularAutomaton {
@@ -101,132 +104,9 @@ std::string ac_hash(const std::string& input, uint32_t rule, size_t steps) {
     return ss.str();
 }
 
-// Version simple de SHA256 (simulée pour comparaison)
-std::string simple_sha256(const std::string& input) {
-    // Simulation simplifiée - dans un vrai projet, utiliser OpenSSL ou crypto++
-    std::hash<std::string> hasher;
-    size_t hash_value = hasher(input);
-    
-    std::stringstream ss;
-    ss << std::hex << std::setw(16) << std::setfill('0') << hash_value;
-    
-    // Compléter à 64 caractères (256 bits)
-    std::string result = ss.str();
-    while (result.length() < 64) {
-        result += "0";
-    }
-    return result.substr(0, 64);
-}
-
 // ==================== BLOCKCHAIN ====================
-
-struct Block {
-    int index;
-    std::time_t timestamp;
-    std::string data;
-    std::string previous_hash;
-    int nonce;
-    std::string hash;
-    
-    Block(int idx, const std::string& d, const std::string& prev_hash)
-        : index(idx), data(d), previous_hash(prev_hash), nonce(0) {
-        timestamp = std::time(nullptr);
-    }
-};
-
-class Blockchain {
-private:
-    std::vector<Block> chain;
-    int difficulty;
-    std::string hash_mode; // "SHA256" ou "AC_HASH"
-    uint32_t ac_rule;
-    size_t ac_steps;
-    
-    std::string calculate_hash(const Block& block) {
-        std::stringstream ss;
-        ss << block.index << block.timestamp << block.data 
-           << block.previous_hash << block.nonce;
-        
-        if (hash_mode == "AC_HASH") {
-            return ac_hash(ss.str(), ac_rule, ac_steps);
-        } else {
-            return simple_sha256(ss.str());
-        }
-    }
-    
-    std::string get_difficulty_prefix() {
-        return std::string(difficulty, '0');
-    }
-    
-public:
-    Blockchain(int diff = 2, const std::string& mode = "SHA256", 
-               uint32_t rule = 30, size_t steps = 128)
-        : difficulty(diff), hash_mode(mode), ac_rule(rule), ac_steps(steps) {
-        // Créer le bloc genesis
-        Block genesis(0, "Genesis Block", "0");
-        genesis.hash = calculate_hash(genesis);
-        chain.push_back(genesis);
-    }
-    
-    // 3.2. Minage avec ac_hash
-    void mine_block(Block& block, int& iterations) {
-        std::string target = get_difficulty_prefix();
-        iterations = 0;
-        
-        do {
-            block.nonce++;
-            block.hash = calculate_hash(block);
-            iterations++;
-        } while (block.hash.substr(0, difficulty) != target);
-    }
-    
-    void add_block(const std::string& data, int& iterations) {
-        Block new_block(chain.size(), data, chain.back().hash);
-        mine_block(new_block, iterations);
-        chain.push_back(new_block);
-    }
-    
-    // 3.3. Validation de bloc
-    bool is_chain_valid() {
-        for (size_t i = 1; i < chain.size(); i++) {
-            const Block& current = chain[i];
-            const Block& previous = chain[i - 1];
-            
-            // Vérifier le hash
-            if (current.hash != calculate_hash(current)) {
-                return false;
-            }
-            
-            // Vérifier le lien avec le bloc précédent
-            if (current.previous_hash != previous.hash) {
-                return false;
-            }
-            
-            // Vérifier la difficulté
-            if (current.hash.substr(0, difficulty) != get_difficulty_prefix()) {
-                return false;
-            }
-        }
-        return true;
-    }
-    
-    void set_hash_mode(const std::string& mode, uint32_t rule = 30, size_t steps = 128) {
-        hash_mode = mode;
-        ac_rule = rule;
-        ac_steps = steps;
-    }
-    
-    void print_chain() {
-        for (const auto& block : chain) {
-            std::cout << "Block #" << block.index << "\n";
-            std::cout << "  Timestamp: " << block.timestamp << "\n";
-            std::cout << "  Data: " << block.data << "\n";
-            std::cout << "  Hash: " << block.hash << "\n";
-            std::cout << "  Previous: " << block.previous_hash << "\n";
-            std::cout << "  Nonce: " << block.nonce << "\n\n";
-        }
-    }
-};
+// Block / Blockchain génériques (hachage et consensus choisis à la
+// compilation): voir policy_blockchain.hpp
 
 // ==================== TESTS ET ANALYSES ====================
 
@@ -283,6 +163,34 @@ double test_bit_distribution(uint32_t rule, size_t steps, int num_samples = 1000
     return (total_ones * 100.0) / total_bits;
 }
 
+// 4. Minage de 10 blocs avec la fonction de hachage Hash; la boucle de
+// minage est instanciée pour Hash, sans test du mode à chaque nonce
+template <class Hash>
+void compare_mode(const std::string& mode, uint32_t rule) {
+    Blockchain<Hash, ProofOfWork> bc(ProofOfWork(2, 100000));
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t total_iterations = 0;
+    int mined = 0;
+    
+    for (int i = 0; i < 10; i++) {
+        uint64_t iterations;
+        if (!bc.add_block("Block " + std::to_string(i), iterations)) break;
+        total_iterations += iterations;
+        mined++;
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    
+    std::cout << mode << "\t";
+    if (rule != 0) std::cout << rule << "\t";
+    else std::cout << "N/A\t";
+    std::cout << duration.count() << "\t\t";
+    if (mined == 10) std::cout << (total_iterations / 10) << "\n";
+    else std::cout << "échec au bloc " << mined << " (cible jamais atteinte)\n";
+}
+
 // ==================== MAIN ====================
 
 int main() {
@@ -318,31 +226,10 @@ int main() {
     std::cout << "Mode\t\tRule\tTemps(ms)\tItérations moy.\n";
     std::cout << "--------------------------------------------------------\n";
     
-    std::vector<std::pair<std::string, uint32_t>> modes = {
-        {"SHA256", 0}, {"AC_HASH", 30}, {"AC_HASH", 90}, {"AC_HASH", 110}
-    };
-    
-    for (auto& [mode, rule] : modes) {
-        Blockchain bc(2, mode, rule, 128);
-        
-        auto start = std::chrono::high_resolution_clock::now();
-        int total_iterations = 0;
-        
-        for (int i = 0; i < 10; i++) {
-            int iterations;
-            bc.add_block("Block " + std::to_string(i), iterations);
-            total_iterations += iterations;
-        }
-        
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-        
-        std::cout << mode << "\t";
-        if (mode == "AC_HASH") std::cout << rule << "\t";
-        else std::cout << "N/A\t";
-        std::cout << duration.count() << "\t\t" 
-                  << (total_iterations / 10) << "\n";
-    }
+    compare_mode<Sha256Hash>("SHA256", 0);
+    compare_mode<AcHash<30>>("AC_HASH", 30);
+    compare_mode<AcHash<90>>("AC_HASH", 90);
+    compare_mode<AcHash<110>>("AC_HASH", 110);
     
     // 5. Effet avalanche
     std::cout << "\n5. Effet avalanche:\n";
@@ -367,12 +254,26 @@ int main() {
     
     // 3.3. Validation de la blockchain
     std::cout << "\n3. Validation de la blockchain avec AC_HASH:\n";
-    Blockchain blockchain(2, "AC_HASH", 30, 128);
-    int iter;
-    blockchain.add_block("Transaction 1", iter);
-    blockchain.add_block("Transaction 2", iter);
+    Blockchain<AcHash<30>, ProofOfWork> blockchain(ProofOfWork(2, 100000));
+    uint64_t iter;
+    for (const char* data : {"Transaction 1", "Transaction 2"}) {
+        bool sealed = blockchain.add_block(data, iter);
+        std::cout << data << ": " << (sealed ? "minée" : "non scellée (aucun hash sous la cible)") << "\n";
+    }
     std::cout << "Blockchain valide: " << (blockchain.is_chain_valid() ? "OUI" : "NON") << "\n";
     
+    Blockchain<Sha256Hash, ProofOfStake> pos_chain;
+    pos_chain.get_consensus().add_validator("Alice", 50);
+    pos_chain.get_consensus().add_validator("Bob", 30);
+    pos_chain.get_consensus().add_validator("Charlie", 20);
+    for (int i = 1; i <= 3; i++) pos_chain.add_block("Transaction " + std::to_string(i), iter);
+    std::cout << "Blockchain " << pos_chain.name() << " (" << pos_chain.size() - 1 << " blocs, validateurs: ";
+    for (size_t i = 1; i < pos_chain.size(); i++) {
+        std::cout << (i > 1 ? ", " : "")
+                  << pos_chain.get_consensus().validator_name(pos_chain.get_chain()[i].header.validator);
+    }
+    std::cout << ") valide: " << (pos_chain.is_chain_valid() ? "OUI" : "NON") << "\n";
+    
     std::cout << "\n=== TESTS TERMINÉS ===\n";
     
     return 0;
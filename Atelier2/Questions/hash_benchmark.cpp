@@ -0,0 +1,247 @@
+// ============================================================
+// Microbenchmark des fonctions de hachage
+// ============================================================
+// Mesure chaque backend (SHA-256, AC_HASH règles 30/90/110, std::hash,
+// OpenSSL avec -DWITH_OPENSSL) sur des entrées de 32 o à 1 Mo:
+//   - échauffement, puis calibrage du nombre d'appels par répétition pour
+//     qu'une répétition dure au moins --min-ms;
+//   - --reps répétitions: ns/hash (moyenne, écart-type, min, médiane) et
+//     débit en octets/s (à partir de la médiane);
+//   - --json <fichier>: mêmes résultats en JSON, pour comparer deux builds.
+//
+//   g++ -std=c++17 -O2 hash_benchmark.cpp policy_blockchain.cpp [-DWITH_OPENSSL -lcrypto]
+//   ./a.out [--reps N] [--min-ms M] [--max-size OCTETS] [--filter NOM] [--json fichier]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "policy_blockchain.hpp"
+
+#if defined(WITH_OPENSSL) && __has_include(<openssl/sha.h>)
+#include <openssl/sha.h>
+#define HASH_BENCHMARK_OPENSSL 1
+#endif
+
+// ==================== BACKENDS ====================
+
+// Ancien simple_sha256 de full_implimentation.cpp: std::hash complété par
+// des zéros (pas un hash cryptographique, gardé comme plancher de coût)
+inline Digest std_hash_256(const uint8_t* data, size_t len) {
+    size_t value = std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(data), len));
+    Digest out = {};
+    std::memcpy(out.data(), &value, sizeof(value));
+    return out;
+}
+
+#ifdef HASH_BENCHMARK_OPENSSL
+inline Digest openssl_sha256(const uint8_t* data, size_t len) {
+    Digest out;
+    SHA256(data, len, out.data());
+    return out;
+}
+#endif
+
+// ==================== MESURE ====================
+
+struct BenchmarkOptions {
+    int repetitions = 10;
+    double min_rep_ms = 20.0;
+    size_t max_size = 1 << 20;
+    std::string filter;
+    std::string json_path;
+};
+
+struct BenchmarkResult {
+    std::string backend;
+    size_t size = 0;
+    uint64_t iterations = 0;   // appels par répétition
+    double mean_ns = 0;
+    double stddev_ns = 0;
+    double min_ns = 0;
+    double median_ns = 0;
+    double bytes_per_second = 0;
+};
+
+// Accumule un octet de chaque digest: empêche le compilateur d'éliminer
+// les appels dont le résultat serait sinon inutilisé
+static volatile uint8_t benchmark_sink = 0;
+
+using Clock = std::chrono::steady_clock;
+
+// Temps (ns) de `iterations` appels de hash sur input
+template <class HashFn>
+double time_calls(HashFn hash, const std::vector<uint8_t>& input, uint64_t iterations) {
+    uint8_t acc = 0;
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < iterations; i++) acc ^= hash(input.data(), input.size())[i % 32];
+    auto end = Clock::now();
+    benchmark_sink = benchmark_sink ^ acc;
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+template <class HashFn>
+BenchmarkResult measure(const std::string& backend, HashFn hash, const std::vector<uint8_t>& input,
+                        const BenchmarkOptions& options) {
+    BenchmarkResult result;
+    result.backend = backend;
+    result.size = input.size();
+
+    // Calibrage: on augmente le nombre d'appels jusqu'à atteindre la durée
+    // minimale d'une répétition, puis une répétition d'échauffement non comptée
+    double target_ns = options.min_rep_ms * 1e6;
+    uint64_t iterations = 1;
+    double elapsed = time_calls(hash, input, iterations);
+    while (elapsed < target_ns) {
+        iterations = (elapsed * 4 < target_ns) ? iterations * 4 : iterations * 2;
+        elapsed = time_calls(hash, input, iterations);
+    }
+    result.iterations = iterations;
+    time_calls(hash, input, iterations);
+
+    std::vector<double> samples;
+    for (int r = 0; r < options.repetitions; r++) {
+        samples.push_back(time_calls(hash, input, iterations) / iterations);
+    }
+
+    double sum = 0;
+    for (double s : samples) sum += s;
+    result.mean_ns = sum / samples.size();
+    double squares = 0;
+    for (double s : samples) squares += (s - result.mean_ns) * (s - result.mean_ns);
+    result.stddev_ns = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0.0;
+
+    std::sort(samples.begin(), samples.end());
+    result.min_ns = samples.front();
+    size_t mid = samples.size() / 2;
+    result.median_ns = (samples.size() % 2 == 1) ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2;
+    result.bytes_per_second = input.size() * 1e9 / result.median_ns;
+    return result;
+}
+
+// ==================== RAPPORTS ====================
+
+std::string format_size(size_t bytes) {
+    if (bytes >= (1 << 20) && bytes % (1 << 20) == 0) return std::to_string(bytes >> 20) + " Mo";
+    if (bytes >= 1024 && bytes % 1024 == 0) return std::to_string(bytes >> 10) + " Ko";
+    return std::to_string(bytes) + " o";
+}
+
+std::string format_rate(double bytes_per_second) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    if (bytes_per_second >= 1e9) ss << bytes_per_second / 1e9 << " Go/s";
+    else if (bytes_per_second >= 1e6) ss << bytes_per_second / 1e6 << " Mo/s";
+    else ss << bytes_per_second / 1e3 << " Ko/s";
+    return ss.str();
+}
+
+void print_result(const BenchmarkResult& r) {
+    double cv = r.mean_ns > 0 ? 100.0 * r.stddev_ns / r.mean_ns : 0.0;
+    std::cout << std::left << std::setw(16) << r.backend << std::right << std::setw(8) << format_size(r.size)
+              << std::fixed << std::setprecision(1) << std::setw(14) << r.median_ns << std::setw(14) << r.mean_ns
+              << std::setw(9) << cv << "%" << std::setw(14) << format_rate(r.bytes_per_second) << "\n";
+}
+
+void write_json(std::ostream& out, const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options) {
+    out << std::setprecision(6);
+    out << "{\n";
+    out << "  \"benchmark\": \"hash\",\n";
+#ifdef __VERSION__
+    out << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+    out << "  \"repetitions\": " << options.repetitions << ",\n";
+    out << "  \"min_repetition_ms\": " << options.min_rep_ms << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& r = results[i];
+        out << "    {\"backend\": \"" << r.backend << "\", \"size\": " << r.size
+            << ", \"iterations\": " << r.iterations
+            << ", \"ns_per_hash\": {\"mean\": " << r.mean_ns << ", \"stddev\": " << r.stddev_ns
+            << ", \"min\": " << r.min_ns << ", \"median\": " << r.median_ns << "}"
+            << ", \"bytes_per_second\": " << r.bytes_per_second << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+// ==================== MAIN ====================
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--reps" && has_value) options.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--min-ms" && has_value) options.min_rep_ms = std::max(0.0, std::atof(argv[++i]));
+        else if (arg == "--max-size" && has_value) options.max_size = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--filter" && has_value) options.filter = argv[++i];
+        else if (arg == "--json" && has_value) options.json_path = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--reps N] [--min-ms M] [--max-size OCTETS] [--filter NOM] [--json fichier]\n";
+            return 1;
+        }
+    }
+
+    // Entrées pseudo-aléatoires déterministes: mêmes octets d'un build à l'autre
+    std::vector<size_t> sizes = {32, 64, 256, 1024, 4096, 65536, 1 << 20};
+    std::mt19937 rng(2024);
+    std::vector<uint8_t> pool(sizes.back());
+    for (uint8_t& b : pool) b = static_cast<uint8_t>(rng());
+
+    std::cout << "=== BENCHMARK DES FONCTIONS DE HACHAGE ===\n";
+    std::cout << options.repetitions << " répétitions de " << options.min_rep_ms << " ms minimum"
+#ifndef HASH_BENCHMARK_OPENSSL
+              << " (sans OpenSSL: compiler avec -DWITH_OPENSSL -lcrypto)"
+#endif
+              << "\n\n";
+    std::cout << std::left << std::setw(16) << "Backend" << std::right << std::setw(8) << "Taille"
+              << std::setw(14) << "ns/hash méd." << std::setw(14) << "ns/hash moy." << std::setw(10) << "CV"
+              << std::setw(14) << "Débit" << "\n";
+    std::cout << std::string(76, '-') << "\n";
+
+    // Chaque backend est passé sous forme de lambda (type distinct): la
+    // boucle de mesure est instanciée pour lui et l'appel reste direct
+    std::vector<BenchmarkResult> results;
+    auto run = [&](const std::string& name, auto hash) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+        for (size_t size : sizes) {
+            if (size > options.max_size) continue;
+            std::vector<uint8_t> input(pool.begin(), pool.begin() + size);
+            results.push_back(measure(name, hash, input, options));
+            print_result(results.back());
+            std::cout << std::flush;
+        }
+    };
+
+    run(Sha256Hash::name(), [](const uint8_t* d, size_t n) { return Sha256Hash::hash(d, n); });
+#ifdef HASH_BENCHMARK_OPENSSL
+    run("OpenSSL SHA256", [](const uint8_t* d, size_t n) { return openssl_sha256(d, n); });
+#endif
+    run(AcHash<30>::name(), [](const uint8_t* d, size_t n) { return AcHash<30>::hash(d, n); });
+    run(AcHash<90>::name(), [](const uint8_t* d, size_t n) { return AcHash<90>::hash(d, n); });
+    run(AcHash<110>::name(), [](const uint8_t* d, size_t n) { return AcHash<110>::hash(d, n); });
+    run("std::hash", [](const uint8_t* d, size_t n) { return std_hash_256(d, n); });
+
+    if (!options.json_path.empty()) {
+        std::ofstream json(options.json_path);
+        if (!json) {
+            std::cerr << "❌ Impossible d'écrire " << options.json_path << "\n";
+            return 1;
+        }
+        write_json(json, results, options);
+        std::cout << "\nRésultats JSON écrits dans " << options.json_path << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,10 @@
+// Instanciations explicites des combinaisons hachage × consensus usuelles
+// (voir POLICY_BLOCKCHAIN_INSTANCES dans policy_blockchain.hpp)
+
+#include "policy_blockchain.hpp"
+
+#define POLICY_BLOCKCHAIN_INSTANTIATE(HASH, CONSENSUS) \
+    template class Block<HASH, CONSENSUS>;             \
+    template class Blockchain<HASH, CONSENSUS>;
+POLICY_BLOCKCHAIN_INSTANCES(POLICY_BLOCKCHAIN_INSTANTIATE)
+#undef POLICY_BLOCKCHAIN_INSTANTIATE
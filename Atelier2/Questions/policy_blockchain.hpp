@@ -0,0 +1,387 @@
+// ============================================================
+// Block / Blockchain paramétrés par politiques
+// ============================================================
+// La fonction de hachage et le consensus sont des paramètres de template:
+//   Blockchain<Sha256Hash, ProofOfWork>, Blockchain<AcHash<30>, ProofOfStake>, ...
+// Chaque combinaison a sa propre boucle de minage, où l'appel au hachage est
+// direct (et inlinable): plus de comparaison de chaîne ni de branche sur le
+// mode à chaque nonce.
+//
+// Les combinaisons usuelles (SHA-256, AC_HASH règles 30/90/110, PoW, PoS)
+// sont instanciées une fois pour toutes dans policy_blockchain.cpp:
+//   g++ -std=c++17 -O2 full_implimentation.cpp policy_blockchain.cpp
+
+#ifndef POLICY_BLOCKCHAIN_HPP
+#define POLICY_BLOCKCHAIN_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Digest = std::array<uint8_t, 32>;
+
+inline std::string to_hex(const Digest& digest) {
+    std::stringstream ss;
+    for (uint8_t byte : digest) ss << std::hex << std::setw(2) << std::setfill('0') << (int)byte;
+    return ss.str();
+}
+
+// ==================== POLITIQUES DE HACHAGE ====================
+// Une politique de hachage fournit hash(données, taille) → 256 bits et name().
+
+// SHA-256 (FIPS 180-4), sans dépendance externe
+struct Sha256Hash {
+    static std::string name() { return "SHA256"; }
+
+    static Digest hash(const uint8_t* data, size_t len) {
+        uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                         0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+        // Blocs complets lus directement, le dernier (ou les deux derniers) avec le padding
+        size_t full = len / 64;
+        for (size_t c = 0; c < full; c++) compress(h, data + 64 * c);
+
+        uint8_t tail[128] = {};
+        size_t rest = len - 64 * full;
+        std::copy(data + 64 * full, data + len, tail);
+        tail[rest] = 0x80;
+        size_t tail_len = (rest < 56) ? 64 : 128;
+        uint64_t bit_len = static_cast<uint64_t>(len) * 8;
+        for (int i = 0; i < 8; i++) tail[tail_len - 1 - i] = static_cast<uint8_t>(bit_len >> (8 * i));
+        for (size_t c = 0; c < tail_len; c += 64) compress(h, tail + c);
+
+        Digest out;
+        for (int i = 0; i < 8; i++) {
+            for (int b = 0; b < 4; b++) out[4 * i + b] = static_cast<uint8_t>(h[i] >> (24 - 8 * b));
+        }
+        return out;
+    }
+
+private:
+    static uint32_t ror(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+    static void compress(uint32_t h[8], const uint8_t* chunk) {
+        static constexpr uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t(chunk[4 * i]) << 24) | (uint32_t(chunk[4 * i + 1]) << 16) |
+                   (uint32_t(chunk[4 * i + 2]) << 8) | uint32_t(chunk[4 * i + 3]);
+        }
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = ror(w[i - 15], 7) ^ ror(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = ror(w[i - 2], 17) ^ ror(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        for (int i = 0; i < 64; i++) {
+            uint32_t t1 = hh + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            hh = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+    }
+};
+
+// Hachage par automate cellulaire (même définition que ac_hash): les bits de
+// l'entrée, complétés par des zéros jusqu'à 256, évoluent Steps fois selon
+// la règle Rule (bords à 0); le hash est formé des 256 premières cellules.
+// Les cellules sont rangées 64 par mot (cellule de gauche = bit de poids
+// fort): un pas de l'automate traite 64 cellules à la fois, et la règle,
+// connue à la compilation, se réduit à quelques opérations logiques.
+template <uint8_t Rule, size_t Steps = 128>
+struct AcHash {
+    static std::string name() { return "AC_HASH(" + std::to_string(Rule) + ")"; }
+
+    static Digest hash(const uint8_t* data, size_t len) {
+        size_t cells = std::max<size_t>(256, 8 * len);
+        size_t words = (cells + 63) / 64;
+
+        // Les en-têtes de bloc tiennent dans la pile; au-delà, allocation
+        constexpr size_t STACK_WORDS = 16;
+        uint64_t stack_state[2 * STACK_WORDS];
+        std::vector<uint64_t> heap_state;
+        uint64_t* state = stack_state;
+        if (words > STACK_WORDS) {
+            heap_state.resize(2 * words);
+            state = heap_state.data();
+        }
+        uint64_t* next = state + words;
+
+        std::fill(state, state + words, 0);
+        for (size_t i = 0; i < len; i++) state[i / 8] |= uint64_t(data[i]) << (56 - 8 * (i % 8));
+        uint64_t tail_mask = (cells % 64 == 0) ? ~uint64_t(0) : ~uint64_t(0) << (64 - cells % 64);
+
+        for (size_t s = 0; s < Steps; s++) {
+            for (size_t j = 0; j < words; j++) {
+                uint64_t center = state[j];
+                uint64_t left = (center >> 1) | (j > 0 ? state[j - 1] << 63 : 0);
+                uint64_t right = (center << 1) | (j + 1 < words ? state[j + 1] >> 63 : 0);
+                next[j] = apply_rule(left, center, right);
+            }
+            next[words - 1] &= tail_mask;
+            std::swap(state, next);
+        }
+
+        Digest out;
+        for (size_t i = 0; i < out.size(); i++) out[i] = static_cast<uint8_t>(state[i / 8] >> (56 - 8 * (i % 8)));
+        return out;
+    }
+
+private:
+    // Bit k de la règle = nouvel état pour le voisinage (gauche, centre, droite) = k
+    static uint64_t apply_rule(uint64_t left, uint64_t center, uint64_t right) {
+        uint64_t out = 0;
+        for (int k = 0; k < 8; k++) {
+            if ((Rule >> k) & 1) {
+                out |= ((k & 4) ? left : ~left) & ((k & 2) ? center : ~center) & ((k & 1) ? right : ~right);
+            }
+        }
+        return out;
+    }
+};
+
+// ==================== EN-TÊTE DE BLOC ====================
+
+// Encodage binaire à largeur fixe: c'est lui qui est haché (les données n'y
+// entrent que par leur hash), et le minage ne réécrit que les octets du nonce.
+// Le nonce vient en tête: l'automate ne propage une cellule que d'un cran
+// par pas, si bien qu'un nonce placé plus loin que 256 + Steps bits
+// n'atteindrait jamais le hash d'AcHash.
+struct BlockHeader {
+    static constexpr size_t SIZE = 88;
+    static constexpr size_t NONCE_OFFSET = 0;
+    static constexpr uint32_t NO_VALIDATOR = 0xffffffff;
+
+    uint64_t nonce = 0;
+    Digest previous_hash = {};
+    Digest data_hash = {};
+    uint32_t index = 0;
+    uint64_t timestamp = 0;
+    uint32_t validator = NO_VALIDATOR;   // PoS: indice du validateur élu
+
+    std::array<uint8_t, SIZE> serialize() const {
+        std::array<uint8_t, SIZE> out = {};
+        size_t pos = 0;
+        auto put = [&out, &pos](uint64_t value, int bytes) {
+            for (int i = 0; i < bytes; i++) out[pos++] = static_cast<uint8_t>(value >> (8 * i));
+        };
+        put(nonce, 8);
+        for (uint8_t b : previous_hash) out[pos++] = b;
+        for (uint8_t b : data_hash) out[pos++] = b;
+        put(index, 4);
+        put(timestamp, 8);
+        put(validator, 4);
+        return out;
+    }
+
+    static void write_nonce(std::array<uint8_t, SIZE>& bytes, uint64_t nonce) {
+        for (int i = 0; i < 8; i++) bytes[NONCE_OFFSET + i] = static_cast<uint8_t>(nonce >> (8 * i));
+    }
+};
+
+// ==================== POLITIQUES DE CONSENSUS ====================
+// Une politique de consensus fournit:
+//   - seal<Hash>(header, hash): scelle l'en-tête et renvoie le nombre de
+//     hachages calculés (0 si le bloc ne peut pas être scellé);
+//   - check(header, hash): vérifie le scellement sans refaire le travail.
+
+// Preuve de travail: `difficulty` zéros hexadécimaux en tête du hash.
+// La recherche est bornée à max_attempts nonces: avec les règles 30 et 110,
+// le bord gauche de l'automate (fixé à 0) se stabilise en motif périodique
+// et le hash ne commence presque jamais par un zéro.
+struct ProofOfWork {
+    int difficulty;
+    uint64_t max_attempts;
+
+    explicit ProofOfWork(int diff = 2, uint64_t max = 1 << 20) : difficulty(diff), max_attempts(max) {}
+
+    static std::string name() { return "PoW"; }
+
+    bool check(const BlockHeader&, const Digest& hash) const {
+        for (int i = 0; i < difficulty; i++) {
+            uint8_t nibble = (i % 2 == 0) ? (hash[i / 2] >> 4) : (hash[i / 2] & 0x0f);
+            if (nibble != 0) return false;
+        }
+        return true;
+    }
+
+    template <class Hash>
+    uint64_t seal(BlockHeader& header, Digest& hash) const {
+        std::array<uint8_t, BlockHeader::SIZE> bytes = header.serialize();
+        for (uint64_t attempts = 1; attempts <= max_attempts; attempts++) {
+            header.nonce++;
+            BlockHeader::write_nonce(bytes, header.nonce);
+            hash = Hash::hash(bytes.data(), bytes.size());
+            if (check(header, hash)) return attempts;
+        }
+        return 0;
+    }
+};
+
+// Preuve d'enjeu: le producteur est tiré au prorata des stakes à partir du
+// hash du bloc précédent (déterministe, vérifiable par tous en O(log n))
+class ProofOfStake {
+private:
+    std::vector<std::string> names;
+    std::vector<uint64_t> cumulative;   // stakes cumulés, pour la recherche dichotomique
+
+public:
+    static std::string name() { return "PoS"; }
+
+    void add_validator(const std::string& validator, uint64_t stake) {
+        names.push_back(validator);
+        cumulative.push_back((cumulative.empty() ? 0 : cumulative.back()) + stake);
+    }
+
+    uint32_t elect(const Digest& previous_hash) const {
+        if (cumulative.empty() || cumulative.back() == 0) return BlockHeader::NO_VALIDATOR;
+        uint64_t draw = 0;
+        for (int i = 0; i < 8; i++) draw = (draw << 8) | previous_hash[i];
+        draw %= cumulative.back();
+        return static_cast<uint32_t>(std::upper_bound(cumulative.begin(), cumulative.end(), draw) -
+                                     cumulative.begin());
+    }
+
+    const std::string& validator_name(uint32_t validator) const { return names[validator]; }
+
+    bool check(const BlockHeader& header, const Digest&) const {
+        return header.validator != BlockHeader::NO_VALIDATOR && header.validator == elect(header.previous_hash);
+    }
+
+    template <class Hash>
+    uint64_t seal(BlockHeader& header, Digest& hash) const {
+        header.validator = elect(header.previous_hash);
+        if (header.validator == BlockHeader::NO_VALIDATOR) return 0;
+        std::array<uint8_t, BlockHeader::SIZE> bytes = header.serialize();
+        hash = Hash::hash(bytes.data(), bytes.size());
+        return 1;
+    }
+};
+
+// ==================== BLOC ====================
+
+template <class Hash, class Consensus>
+class Block {
+public:
+    BlockHeader header;
+    std::string data;
+    Digest hash = {};
+
+    Block(uint32_t index, const std::string& block_data, const Digest& previous_hash)
+        : data(block_data) {
+        header.index = index;
+        header.timestamp = static_cast<uint64_t>(std::time(nullptr));
+        header.previous_hash = previous_hash;
+        header.data_hash = Hash::hash(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    }
+
+    Digest compute_hash() const {
+        std::array<uint8_t, BlockHeader::SIZE> bytes = header.serialize();
+        return Hash::hash(bytes.data(), bytes.size());
+    }
+
+    // Minage (PoW) ou signature de l'élu (PoS); nombre de hachages calculés
+    uint64_t seal(const Consensus& consensus) {
+        return consensus.template seal<Hash>(header, hash);
+    }
+
+    bool is_valid(const Consensus& consensus) const {
+        Digest data_hash = Hash::hash(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        return data_hash == header.data_hash && hash == compute_hash() && consensus.check(header, hash);
+    }
+};
+
+// ==================== BLOCKCHAIN ====================
+
+template <class Hash, class Consensus>
+class Blockchain {
+public:
+    using BlockType = Block<Hash, Consensus>;
+
+private:
+    std::vector<BlockType> chain;
+    Consensus consensus;
+
+public:
+    explicit Blockchain(const Consensus& rules = Consensus()) : consensus(rules) {
+        // Le genesis n'est pas scellé: son hash est celui de son en-tête
+        BlockType genesis(0, "Genesis Block", Digest{});
+        genesis.hash = genesis.compute_hash();
+        chain.push_back(genesis);
+    }
+
+    // Ajoute un bloc; attempts reçoit le nombre de hachages calculés
+    bool add_block(const std::string& data, uint64_t& attempts) {
+        BlockType block(static_cast<uint32_t>(chain.size()), data, chain.back().hash);
+        attempts = block.seal(consensus);
+        if (attempts == 0) return false;
+        chain.push_back(block);
+        return true;
+    }
+
+    bool is_chain_valid() const {
+        if (chain.empty() || chain[0].hash != chain[0].compute_hash()) return false;
+        for (size_t i = 1; i < chain.size(); i++) {
+            if (chain[i].header.previous_hash != chain[i - 1].hash) return false;
+            if (chain[i].header.index != i) return false;
+            if (!chain[i].is_valid(consensus)) return false;
+        }
+        return true;
+    }
+
+    void print_chain() const {
+        for (const auto& block : chain) {
+            std::cout << "Block #" << block.header.index << "\n";
+            std::cout << "  Timestamp: " << block.header.timestamp << "\n";
+            std::cout << "  Data: " << block.data << "\n";
+            std::cout << "  Hash: " << to_hex(block.hash) << "\n";
+            std::cout << "  Previous: " << to_hex(block.header.previous_hash) << "\n";
+            std::cout << "  Nonce: " << block.header.nonce << "\n\n";
+        }
+    }
+
+    static std::string name() { return Hash::name() + "/" + Consensus::name(); }
+
+    Consensus& get_consensus() { return consensus; }
+    const std::vector<BlockType>& get_chain() const { return chain; }
+    size_t size() const { return chain.size(); }
+};
+
+// ==================== INSTANCIATIONS EXPLICITES ====================
+// Définies dans policy_blockchain.cpp: les programmes qui incluent ce fichier
+// ne recompilent pas ces combinaisons.
+
+#define POLICY_BLOCKCHAIN_INSTANCES(X) \
+    X(Sha256Hash, ProofOfWork)         \
+    X(Sha256Hash, ProofOfStake)        \
+    X(AcHash<30>, ProofOfWork)         \
+    X(AcHash<30>, ProofOfStake)        \
+    X(AcHash<90>, ProofOfWork)         \
+    X(AcHash<90>, ProofOfStake)        \
+    X(AcHash<110>, ProofOfWork)        \
+    X(AcHash<110>, ProofOfStake)
+
+#define POLICY_BLOCKCHAIN_EXTERN(HASH, CONSENSUS) \
+    extern template class Block<HASH, CONSENSUS>; \
+    extern template class Blockchain<HASH, CONSENSUS>;
+POLICY_BLOCKCHAIN_INSTANCES(POLICY_BLOCKCHAIN_EXTERN)
+#undef POLICY_BLOCKCHAIN_EXTERN
+
+#endif